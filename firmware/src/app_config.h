@@ -65,6 +65,9 @@ struct ProximityState
 {
     uint16_t RangeMilliMeter;
     uint8_t RangeStatus;
+    // Incremented with every new measurement, so a consumer of the (more often republished) SensorsState can tell a new
+    // reading from one it already saw; 0 until the first measurement
+    uint32_t sequence;
 };
 
 struct StrainState
@@ -87,6 +90,13 @@ struct SensorsState
     SystemState system;
 };
 
+// A change of StrainState::virtual_button_code
+struct VirtualButtonEvent
+{
+    uint8_t code;
+    unsigned long at_ms;
+};
+
 struct ScreenState
 {
     bool has_been_engaged;
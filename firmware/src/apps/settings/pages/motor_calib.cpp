@@ -8,7 +8,7 @@ void motor_calib_timer(lv_timer_t *timer)
 
     lv_label_set_text_fmt(state->prompt_label, "DONT TOUCH KNOB");
     lv_obj_set_style_text_color(state->prompt_label, LV_COLOR_MAKE(0xFF, 0xB4, 0x50), LV_PART_MAIN);
-    lv_label_set_text_fmt(state->time_label, "%02ds", (45000 - (now - state->start_ms)) / 1000);
+    lv_label_set_text_fmt(state->time_label, "%02ds", (20000 - (now - state->start_ms)) / 1000);
     if (!state->timer_running)
     {
         lv_obj_align_to(state->time_label, state->prompt_label, LV_ALIGN_OUT_BOTTOM_MID, 0, 12);
@@ -20,7 +20,7 @@ void motor_calib_timer(lv_timer_t *timer)
         state->is_calibrating = true;
     }
 
-    if ((now - state->start_ms) > 45000)
+    if ((now - state->start_ms) > 20000)
     {
         lv_timer_del(timer);
 
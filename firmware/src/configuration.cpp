@@ -90,11 +90,12 @@ bool Configuration::loadFromDisk()
     snprintf(
         buf_,
         sizeof(buf_),
-        "Motor calibration: calib=%u, pole_pairs=%u, zero_offset=%.2f, cw=%u",
+        "Motor calibration: calib=%u, pole_pairs=%u, zero_offset=%.2f, cw=%u, angle_correction=%u",
         pb_buffer_.motor.calibrated,
         pb_buffer_.motor.pole_pairs,
         pb_buffer_.motor.zero_electrical_offset,
-        pb_buffer_.motor.direction_cw);
+        pb_buffer_.motor.direction_cw,
+        pb_buffer_.motor.angle_correction_count);
     LOGI(buf_);
 
     return true;
@@ -420,6 +421,16 @@ bool Configuration::setMotorCalibrationAndSave(PB_MotorCalibration &motor_calibr
     return saveToDisk();
 }
 
+bool Configuration::setGainScheduleAndSave(PB_GainSchedule &gain_schedule)
+{
+    {
+        SemaphoreGuard lock(mutex_);
+        pb_buffer_.gain_schedule = gain_schedule;
+        pb_buffer_.has_gain_schedule = true;
+    }
+    return saveToDisk();
+}
+
 void Configuration::setSharedEventsQueue(QueueHandle_t shared_events_queue)
 {
     this->shared_events_queue = shared_events_queue;
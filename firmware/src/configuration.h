@@ -111,6 +111,7 @@ public:
     SETTINGS_Settings getSettings();
 
     bool setMotorCalibrationAndSave(PB_MotorCalibration &motor_calibration);
+    bool setGainScheduleAndSave(PB_GainSchedule &gain_schedule);
     bool saveWiFiConfiguration(WiFiConfiguration wifi_config);
     WiFiConfiguration getWiFiConfiguration();
     bool loadWiFiConfiguration();
@@ -0,0 +1,107 @@
+#include "engagement_estimator.h"
+
+// Proximity evidence is full strength up to ENGAGE_RANGE_MM and fades out by APPROACH_RANGE_MM
+static const uint16_t ENGAGE_RANGE_MM = 200;
+static const uint16_t APPROACH_RANGE_MM = 400;
+// VL53L0X range status: 0 is a valid measurement, 1/2 are sigma/signal warnings (usually still right up close), the
+// rest are failures
+static const float PROXIMITY_STATUS_WEIGHTS[] = {1.0, 0.6, 0.6};
+// Weight of each new reading; a single valid reading in engage range is enough to engage
+static const float PROXIMITY_ALPHA = 0.5;
+static const float PROXIMITY_ENGAGED_CONFIDENCE = 0.5;
+static const float PROXIMITY_APPROACHING_CONFIDENCE = 0.1;
+static const unsigned long APPROACH_HOLD_MS = 2000;
+
+// Rotation counts once the knob moved a third of a detent from where it last counted, which ignores sensor jitter
+static const float ROTATION_STEP = 1 / 3.0;
+
+static bool before(unsigned long now_ms, unsigned long until_ms)
+{
+    return (long)(until_ms - now_ms) > 0;
+}
+
+void EngagementEstimator::setHoldTimes(unsigned long press_hold_ms, unsigned long rotation_hold_ms, unsigned long proximity_hold_ms)
+{
+    press_hold_ms_ = press_hold_ms;
+    rotation_hold_ms_ = rotation_hold_ms;
+    proximity_hold_ms_ = proximity_hold_ms;
+}
+
+void EngagementEstimator::extend(unsigned long &until_ms, unsigned long now_ms, unsigned long hold_ms)
+{
+    if (!before(now_ms + hold_ms, until_ms))
+    {
+        until_ms = now_ms + hold_ms;
+    }
+}
+
+void EngagementEstimator::addButton(const VirtualButtonEvent &event)
+{
+    if (event.code == VIRTUAL_BUTTON_IDLE)
+    {
+        return;
+    }
+    extend(engaged_until_ms_, event.at_ms, press_hold_ms_);
+    state_.last_physical_ms = event.at_ms;
+}
+
+void EngagementEstimator::addRotation(float sub_position_unit, unsigned long now_ms)
+{
+    if (has_rotation_anchor_ && fabsf(sub_position_unit - rotation_anchor_) < ROTATION_STEP)
+    {
+        return;
+    }
+    if (has_rotation_anchor_)
+    {
+        extend(engaged_until_ms_, now_ms, rotation_hold_ms_);
+        state_.last_physical_ms = now_ms;
+    }
+    has_rotation_anchor_ = true;
+    rotation_anchor_ = sub_position_unit;
+}
+
+void EngagementEstimator::addProximity(const ProximityState &proximity, unsigned long now_ms)
+{
+    float evidence = 0;
+    if (proximity.RangeStatus < sizeof(PROXIMITY_STATUS_WEIGHTS) / sizeof(PROXIMITY_STATUS_WEIGHTS[0]) && proximity.RangeMilliMeter < APPROACH_RANGE_MM)
+    {
+        float distance_weight = proximity.RangeMilliMeter <= ENGAGE_RANGE_MM ? 1 : (float)(APPROACH_RANGE_MM - proximity.RangeMilliMeter) / (APPROACH_RANGE_MM - ENGAGE_RANGE_MM);
+        evidence = PROXIMITY_STATUS_WEIGHTS[proximity.RangeStatus] * distance_weight;
+    }
+    state_.proximity_confidence += PROXIMITY_ALPHA * (evidence - state_.proximity_confidence);
+
+    if (state_.proximity_confidence >= PROXIMITY_ENGAGED_CONFIDENCE)
+    {
+        extend(engaged_until_ms_, now_ms, proximity_hold_ms_);
+    }
+    else if (state_.proximity_confidence >= PROXIMITY_APPROACHING_CONFIDENCE)
+    {
+        extend(approaching_until_ms_, now_ms, APPROACH_HOLD_MS);
+    }
+}
+
+void EngagementEstimator::wake(unsigned long hold_ms, unsigned long now_ms)
+{
+    extend(engaged_until_ms_, now_ms, hold_ms);
+}
+
+const EngagementState &EngagementEstimator::update(unsigned long now_ms)
+{
+    EngagementLevel level = EngagementLevel::IDLE;
+    if (before(now_ms, engaged_until_ms_))
+    {
+        level = EngagementLevel::ENGAGED;
+    }
+    else if (before(now_ms, approaching_until_ms_))
+    {
+        level = EngagementLevel::APPROACHING;
+    }
+
+    if (level != state_.level)
+    {
+        state_.level = level;
+        state_.since_ms = now_ms;
+    }
+    state_.engaged_until_ms = level == EngagementLevel::ENGAGED ? engaged_until_ms_ : 0;
+    return state_;
+}
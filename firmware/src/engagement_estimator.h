@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "app_config.h"
+
+enum class EngagementLevel : uint8_t
+{
+    IDLE,
+    // Someone may be about to use the knob (e.g. a hand in proximity range); wake what takes time to come up
+    APPROACHING,
+    ENGAGED,
+};
+
+struct EngagementState
+{
+    EngagementLevel level;
+    // When level last changed
+    unsigned long since_ms;
+    // Engaged at least until then, 0 if not engaged
+    unsigned long engaged_until_ms;
+    // Last time the knob was touched (pressed or turned), 0 if never
+    unsigned long last_physical_ms;
+    // Smoothed proximity evidence in [0, 1]
+    float proximity_confidence;
+};
+
+// Fuses the signals that someone is using the knob (presses, rotation, proximity) into a single engagement level.
+// Each signal extends how long the knob stays engaged by its own hold time; physical contact is trusted outright,
+// while proximity readings are weighted by the sensor's range status and distance and smoothed, so one marginal
+// reading only counts as approaching. Other events that should light up the knob (errors, calibration) call wake().
+class EngagementEstimator
+{
+public:
+    void setHoldTimes(unsigned long press_hold_ms, unsigned long rotation_hold_ms, unsigned long proximity_hold_ms);
+
+    void addButton(const VirtualButtonEvent &event);
+    void addRotation(float sub_position_unit, unsigned long now_ms);
+    // Call once per new measurement (ProximityState::sequence), not for every republished SensorsState
+    void addProximity(const ProximityState &proximity, unsigned long now_ms);
+    void wake(unsigned long hold_ms, unsigned long now_ms);
+
+    const EngagementState &update(unsigned long now_ms);
+
+    const EngagementState &state() const
+    {
+        return state_;
+    }
+
+private:
+    unsigned long press_hold_ms_ = 0;
+    unsigned long rotation_hold_ms_ = 0;
+    unsigned long proximity_hold_ms_ = 0;
+
+    unsigned long engaged_until_ms_ = 0;
+    unsigned long approaching_until_ms_ = 0;
+
+    bool has_rotation_anchor_ = false;
+    float rotation_anchor_ = 0;
+
+    EngagementState state_ = {};
+
+    void extend(unsigned long &until_ms, unsigned long now_ms, unsigned long hold_ms);
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size, allocation-free signal filters. Everything is sized at compile time and costs O(1) per sample (O(N) for
+// the median, where N is a small window), so they're safe to use from any task at any sample rate.
+
+// Moving average over the last N samples, using a ring buffer and a running sum. Until N samples have been added it
+// averages over the ones it has, so there's no ramp up from zero.
+template <size_t N>
+class MovingAverage
+{
+    static_assert(N > 0, "MovingAverage needs at least one sample");
+
+public:
+    float addSample(float value)
+    {
+        if (count_ == N)
+        {
+            sum_ -= samples_[head_];
+        }
+        else
+        {
+            count_++;
+        }
+        samples_[head_] = value;
+        sum_ += value;
+        head_ = (head_ + 1) % N;
+
+        // Re-sum once per window so float rounding in the running sum can't accumulate
+        if (head_ == 0)
+        {
+            sum_ = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                sum_ += samples_[i];
+            }
+        }
+
+        value_ = sum_ / count_;
+        return value_;
+    }
+
+    float getValue() const
+    {
+        return value_;
+    }
+
+    // Set the whole window to value, e.g. to prime the filter with its first reading
+    void fill(float value)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            samples_[i] = value;
+        }
+        sum_ = value * N;
+        count_ = N;
+        head_ = 0;
+        value_ = value;
+    }
+
+    void reset()
+    {
+        sum_ = 0;
+        count_ = 0;
+        head_ = 0;
+        value_ = 0;
+    }
+
+private:
+    float samples_[N] = {};
+    float sum_ = 0;
+    size_t count_ = 0;
+    size_t head_ = 0;
+    float value_ = 0;
+};
+
+// Exponentially weighted moving average. alpha is the weight of each new sample (1 = no filtering).
+class Ewma
+{
+public:
+    explicit Ewma(float alpha) : alpha_(alpha) {}
+
+    float addSample(float value)
+    {
+        value_ = primed_ ? value_ + alpha_ * (value - value_) : value;
+        primed_ = true;
+        return value_;
+    }
+
+    float getValue() const
+    {
+        return value_;
+    }
+
+    void setAlpha(float alpha)
+    {
+        alpha_ = alpha;
+    }
+
+    void reset()
+    {
+        primed_ = false;
+        value_ = 0;
+    }
+
+    // Smoothing factor for a first-order low-pass with the given cutoff, sampled every dt_s
+    static float alphaFor(float cutoff_hz, float dt_s)
+    {
+        float tau = 1 / (2 * (float)M_PI * cutoff_hz);
+        return 1 / (1 + tau / dt_s);
+    }
+
+private:
+    float alpha_;
+    float value_ = 0;
+    bool primed_ = false;
+};
+
+// Median of the last N samples; rejects single-sample spikes without smearing edges like an average does. Until N
+// samples have been added it takes the median of the ones it has.
+template <size_t N>
+class MedianFilter
+{
+    static_assert(N > 0 && N <= 15, "MedianFilter sorts its window on every sample, keep it small");
+
+public:
+    float addSample(float value)
+    {
+        samples_[head_] = value;
+        head_ = (head_ + 1) % N;
+        if (count_ < N)
+        {
+            count_++;
+        }
+
+        // Insertion sort of a copy; for a handful of samples this beats anything cleverer
+        float sorted[N];
+        for (size_t i = 0; i < count_; i++)
+        {
+            float v = samples_[i];
+            size_t j = i;
+            while (j > 0 && sorted[j - 1] > v)
+            {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = v;
+        }
+        value_ = count_ % 2 ? sorted[count_ / 2] : (sorted[count_ / 2 - 1] + sorted[count_ / 2]) / 2;
+        return value_;
+    }
+
+    float getValue() const
+    {
+        return value_;
+    }
+
+    void reset()
+    {
+        count_ = 0;
+        head_ = 0;
+        value_ = 0;
+    }
+
+private:
+    float samples_[N] = {};
+    size_t count_ = 0;
+    size_t head_ = 0;
+    float value_ = 0;
+};
+
+// One-euro filter (Casiez et al.): a low-pass whose cutoff rises with the signal's rate of change. Slow signals get
+// min_cutoff_hz for low jitter, fast ones a higher cutoff for low lag; beta sets how quickly it opens up.
+class OneEuroFilter
+{
+public:
+    OneEuroFilter(float min_cutoff_hz, float beta, float derivative_cutoff_hz = 1)
+        : min_cutoff_hz_(min_cutoff_hz), beta_(beta), derivative_cutoff_hz_(derivative_cutoff_hz), value_(1), derivative_(1)
+    {
+    }
+
+    float addSample(float value, float dt_s)
+    {
+        if (!primed_)
+        {
+            primed_ = true;
+            last_raw_ = value;
+            derivative_.addSample(0);
+            return value_.addSample(value);
+        }
+        if (dt_s <= 0)
+        {
+            return value_.getValue();
+        }
+
+        derivative_.setAlpha(Ewma::alphaFor(derivative_cutoff_hz_, dt_s));
+        float rate = derivative_.addSample((value - last_raw_) / dt_s);
+        last_raw_ = value;
+
+        float cutoff_hz = min_cutoff_hz_ + beta_ * fabsf(rate);
+        value_.setAlpha(Ewma::alphaFor(cutoff_hz, dt_s));
+        return value_.addSample(value);
+    }
+
+    float getValue() const
+    {
+        return value_.getValue();
+    }
+
+    void reset()
+    {
+        primed_ = false;
+        value_.reset();
+        derivative_.reset();
+    }
+
+private:
+    float min_cutoff_hz_;
+    float beta_;
+    float derivative_cutoff_hz_;
+    Ewma value_;
+    Ewma derivative_;
+    float last_raw_ = 0;
+    bool primed_ = false;
+};
@@ -0,0 +1,178 @@
+#include "i2c_bus.h"
+#include "logging.h"
+#include "semaphore_guard.h"
+
+// Above the sensors task so queued polls run promptly, below the motor task which takes the bus synchronously
+static const UBaseType_t I2C_BUS_TASK_PRIORITY = 2;
+static const uint8_t I2C_QUEUE_LENGTH = 4;
+static const uint32_t I2C_CLOCK_HZ = 400000;
+static const uint32_t BUDGET_WINDOW_MILLIS = 1000;
+static const uint32_t STATS_INTERVAL_MILLIS = 10000;
+
+I2cBus::I2cBus(const uint8_t task_core) : Task("I2cBus", 1024 * 4, I2C_BUS_TASK_PRIORITY, task_core)
+{
+    mutex_ = xSemaphoreCreateMutex();
+    assert(mutex_ != NULL);
+
+    for (QueueHandle_t &queue : queues_)
+    {
+        queue = xQueueCreate(I2C_QUEUE_LENGTH, sizeof(I2cJob));
+        assert(queue != NULL);
+    }
+}
+
+I2cBus::~I2cBus()
+{
+    for (QueueHandle_t queue : queues_)
+    {
+        vQueueDelete(queue);
+    }
+    vSemaphoreDelete(mutex_);
+}
+
+uint8_t I2cBus::addDevice(const char *name, I2cPriority priority, uint32_t budget_us_per_second)
+{
+    SemaphoreGuard lock(mutex_);
+    assert(device_count_ < I2C_MAX_DEVICES);
+    devices_[device_count_] = {
+        .name = name,
+        .priority = priority,
+        .budget_us_per_second = budget_us_per_second,
+    };
+    return device_count_++;
+}
+
+bool I2cBus::submit(const I2cJob &job)
+{
+    if (xQueueSendToBack(queues_[(uint8_t)devices_[job.device].priority], &job, 0) != pdTRUE)
+    {
+        return false;
+    }
+    xTaskNotifyGive(getHandle());
+    return true;
+}
+
+void I2cBus::acquire()
+{
+    // Only until the bus task has initialized Wire at startup
+    while (!ready_.load(std::memory_order_acquire))
+    {
+        delay(1);
+    }
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+}
+
+void I2cBus::release(uint8_t device, uint32_t busy_us)
+{
+    Device &d = devices_[device];
+    d.window_busy_us += busy_us;
+    d.stats.transactions++;
+    d.stats.busy_us += busy_us;
+    d.stats.max_us = max(d.stats.max_us, busy_us);
+    xSemaphoreGive(mutex_);
+}
+
+bool I2cBus::overBudget(uint8_t device)
+{
+    if (millis() - window_start_ms_ >= BUDGET_WINDOW_MILLIS)
+    {
+        for (uint8_t i = 0; i < device_count_; i++)
+        {
+            devices_[i].window_busy_us = 0;
+        }
+        window_start_ms_ = millis();
+    }
+
+    const Device &d = devices_[device];
+    return d.budget_us_per_second != 0 && d.window_busy_us >= d.budget_us_per_second;
+}
+
+void I2cBus::run()
+{
+    {
+        SemaphoreGuard lock(mutex_);
+        Wire.begin(PIN_SDA, PIN_SCL);
+        Wire.setClock(I2C_CLOCK_HZ);
+    }
+    ready_.store(true, std::memory_order_release);
+
+    uint32_t last_stats = millis();
+    I2cJob job;
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STATS_INTERVAL_MILLIS));
+
+        while (popJob(job))
+        {
+            xSemaphoreTake(mutex_, portMAX_DELAY);
+            if (overBudget(job.device))
+            {
+                devices_[job.device].stats.deferred++;
+                xSemaphoreGive(mutex_);
+                job.done(job.context, I2cResult::DEFERRED);
+                continue;
+            }
+            uint32_t start_us = micros();
+            bool ok = job.run(job.context);
+            release(job.device, micros() - start_us);
+
+            job.done(job.context, ok ? I2cResult::OK : I2cResult::FAILED);
+        }
+
+        if (millis() - last_stats > STATS_INTERVAL_MILLIS)
+        {
+            logStats();
+            last_stats = millis();
+        }
+    }
+}
+
+bool I2cBus::popJob(I2cJob &job)
+{
+    // Queues are ordered by priority
+    for (QueueHandle_t queue : queues_)
+    {
+        if (xQueueReceive(queue, &job, 0) == pdTRUE)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void I2cBus::logStats()
+{
+    Device devices[I2C_MAX_DEVICES];
+    uint8_t device_count;
+    {
+        SemaphoreGuard lock(mutex_);
+        device_count = device_count_;
+        for (uint8_t i = 0; i < device_count; i++)
+        {
+            devices[i] = devices_[i];
+            devices_[i].stats = {};
+        }
+    }
+
+    for (uint8_t i = 0; i < device_count; i++)
+    {
+        const I2cDeviceStats &stats = devices[i].stats;
+        LOGV(PB_LogLevel_DEBUG, "I2C %s: %u transactions, %.1f%% of bus time, max %uus, %u deferred",
+             devices[i].name,
+             stats.transactions,
+             stats.busy_us * 100.0f / (STATS_INTERVAL_MILLIS * 1000),
+             stats.max_us,
+             stats.deferred);
+    }
+}
+
+I2cLease::I2cLease(I2cBus &bus, uint8_t device) : bus_(bus), device_(device)
+{
+    bus_.acquire();
+    start_us_ = micros();
+}
+
+I2cLease::~I2cLease()
+{
+    bus_.release(device_, micros() - start_us_);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <atomic>
+
+#include "task.h"
+
+static const uint8_t I2C_MAX_DEVICES = 4;
+
+enum class I2cPriority : uint8_t
+{
+    // Reads the motor loop depends on (e.g. the TLV493D angle sensor)
+    CRITICAL,
+    NORMAL,
+    BACKGROUND,
+    COUNT,
+};
+
+enum class I2cResult : uint8_t
+{
+    OK,
+    FAILED,
+    // Not run because the device used up its bus time budget for the current second; submit again later
+    DEFERRED,
+};
+
+struct I2cJob
+{
+    uint8_t device;
+    // Runs on the bus task while it holds the bus. Returns false if the transfer failed.
+    bool (*run)(void *context);
+    // Runs on the bus task once the job finished or was deferred
+    void (*done)(void *context, I2cResult result);
+    void *context;
+};
+
+struct I2cDeviceStats
+{
+    uint32_t transactions;
+    uint32_t deferred;
+    uint32_t busy_us;
+    uint32_t max_us;
+};
+
+// Arbitrates the shared sensor I²C bus (Wire). The drivers do their own blocking transfers, so the bus is handed out in
+// whole driver calls rather than individual transfers:
+//  - Synchronous leases (I2cLease) for callers that need the result right away, e.g. the motor loop reading the
+//    TLV493D. The bus is a FreeRTOS mutex, so a waiting higher-priority task gets it as soon as the current holder is
+//    done, and priority inheritance keeps the holder from being starved meanwhile.
+//  - Asynchronous jobs (submit) for periodic sensor polling. The bus task runs them one at a time in device priority
+//    order, and each job only holds the bus for its own transfers, so motor reads can cut in between any two of them.
+// Each device may have a bus time budget per second; jobs over budget are deferred. Per-device bus time is logged
+// periodically.
+class I2cBus : public Task<I2cBus>
+{
+    friend class Task<I2cBus>; // Allow base Task to invoke protected run()
+
+public:
+    I2cBus(const uint8_t task_core);
+    ~I2cBus();
+
+    // budget_us_per_second of 0 means unlimited
+    uint8_t addDevice(const char *name, I2cPriority priority, uint32_t budget_us_per_second = 0);
+
+    // Queue a job; returns false if the queue for the device's priority is full.
+    bool submit(const I2cJob &job);
+
+    TwoWire &wire()
+    {
+        return Wire;
+    }
+
+protected:
+    void run();
+
+private:
+    friend class I2cLease;
+
+    struct Device
+    {
+        const char *name;
+        I2cPriority priority;
+        uint32_t budget_us_per_second;
+        uint32_t window_busy_us;
+        I2cDeviceStats stats;
+    };
+
+    SemaphoreHandle_t mutex_;
+    QueueHandle_t queues_[(uint8_t)I2cPriority::COUNT];
+    std::atomic<bool> ready_{false};
+
+    Device devices_[I2C_MAX_DEVICES] = {};
+    uint8_t device_count_ = 0;
+    uint32_t window_start_ms_ = 0;
+
+    void acquire();
+    void release(uint8_t device, uint32_t busy_us);
+    bool overBudget(uint8_t device);
+    bool popJob(I2cJob &job);
+    void logStats();
+};
+
+// Holds the bus for the lifetime of the lease, e.g. around a driver call that talks to the device.
+class I2cLease
+{
+public:
+    I2cLease(I2cBus &bus, uint8_t device);
+    ~I2cLease();
+    I2cLease(I2cLease const &) = delete;
+    I2cLease &operator=(I2cLease const &) = delete;
+
+private:
+    I2cBus &bus_;
+    const uint8_t device_;
+    uint32_t start_us_;
+};
@@ -5,7 +5,14 @@
 #include "proto_gen/smartknob.pb.h"
 
 typedef std::function<void(PB_SmartKnobConfig &)> ConfigCallback;
+typedef std::function<bool(PB_DetentPositions &)> DetentPositionsCallback;
+typedef std::function<bool(PB_HapticEffect &)> HapticEffectCallback;
 typedef std::function<void(void)> MotorCalibrationCallback;
+typedef std::function<void(void)> MotorAutotuneCallback;
+typedef std::function<bool(PB_MotorTiming &)> MotorTimingCallback;
+typedef std::function<bool(PB_MotorThermal &)> MotorThermalCallback;
+typedef std::function<bool(PB_SmartKnobCommand)> SensorRecorderCallback;
+typedef std::function<bool(uint32_t, PB_SensorRecording &)> SensorRecordingCallback;
 typedef std::function<void(float)> StrainCalibrationCallback;
 typedef std::function<void(float)> FactoryStrainCalibrationCallback;
 typedef std::function<void(void)> WeightMeasurementCallback;
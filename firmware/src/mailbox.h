@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+// Lock-free handoffs between tasks for cases where a FreeRTOS queue is too heavy: producers never block and the
+// consumer only pays for a couple of atomic loads when there's nothing new.
+
+// Single-writer "latest value wins" slot. The writer alternates between two buffers, each guarded by its own sequence
+// (odd while being written), so a reader only ever sees a torn copy if the writer completed a second update in the
+// middle of its copy. The reader never spins; if a copy was torn it just reports nothing new and picks the value up
+// next time.
+template <typename T>
+class LatestMailbox
+{
+public:
+    LatestMailbox() : generation_(0)
+    {
+        for (Slot &slot : slots_)
+        {
+            slot.sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Writer side: publish value as the latest. Only one task may write.
+    void put(const T &value)
+    {
+        uint32_t generation = generation_.load(std::memory_order_relaxed) + 1;
+        Slot &slot = slots_[generation & 1];
+
+        slot.sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&slot.value, &value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.sequence.fetch_add(1, std::memory_order_relaxed);
+
+        generation_.store(generation, std::memory_order_release);
+    }
+
+    // Reader side: copy the latest value into out if it's newer than last_generation (updating last_generation).
+    // Returns false if there's nothing new (or the copy raced a writer, in which case try again later).
+    bool take(T &out, uint32_t &last_generation) const
+    {
+        uint32_t generation = generation_.load(std::memory_order_acquire);
+        if (generation == last_generation)
+        {
+            return false;
+        }
+
+        const Slot &slot = slots_[generation & 1];
+        uint32_t start = slot.sequence.load(std::memory_order_acquire);
+        if ((start & 1) != 0)
+        {
+            return false;
+        }
+        memcpy(&out, &slot.value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != start)
+        {
+            return false;
+        }
+
+        last_generation = generation;
+        return true;
+    }
+
+    uint32_t generation() const
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+
+    std::atomic<uint32_t> generation_;
+    Slot slots_[2];
+};
+
+// Bounded multi-producer, single-consumer ring (each cell carries a sequence number so producers can claim cells with
+// a single compare-and-swap). push() fails instead of blocking when the ring is full. N must be a power of two.
+template <typename T, uint8_t N>
+class MpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "MpscRing size must be a power of two");
+
+public:
+    MpscRing() : head_(0), tail_(0)
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T &value)
+    {
+        uint32_t position = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells_[position & (N - 1)];
+            int32_t diff = (int32_t)(cell.sequence.load(std::memory_order_acquire) - position);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Full
+                return false;
+            }
+            else
+            {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side (one task only)
+    bool pop(T &out)
+    {
+        uint32_t position = tail_;
+        Cell &cell = cells_[position & (N - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            return false;
+        }
+        out = cell.value;
+        cell.sequence.store(position + N, std::memory_order_release);
+        tail_ = position + 1;
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+
+    std::atomic<uint32_t> head_;
+    uint32_t tail_;
+    Cell cells_[N];
+};
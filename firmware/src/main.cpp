@@ -1,6 +1,7 @@
 #include <Arduino.h>
 
 #include "configuration.h"
+#include "i2c_bus.h"
 #include "display_task.h"
 #include "root_task.h"
 #include "motor_foc/motor_task.h"
@@ -27,7 +28,10 @@ static LedRingTask *led_ring_task_p = &led_ring_task;
 static LedRingTask *led_ring_task_p = nullptr;
 #endif
 
-static MotorTask motor_task(1, config);
+// Shared by the TLV493D (motor loop), VL53L0X and VEML7700
+static I2cBus i2c_bus(1);
+
+static MotorTask motor_task(1, config, i2c_bus);
 
 #if SK_WIFI
 static WifiTask wifi_task(1);
@@ -45,7 +49,7 @@ static MqttTask *mqtt_task_p = nullptr;
 
 #endif
 
-static SensorsTask sensors_task(1, &config);
+static SensorsTask sensors_task(1, &config, &i2c_bus);
 static SensorsTask *sensors_task_p = &sensors_task;
 
 static ResetTask reset_task(1, config);
@@ -66,6 +70,8 @@ void setup()
 
     initTempSensor();
 
+    i2c_bus.begin();
+
     // TODO: move from eeprom to ffatfs
     if (!EEPROM.begin(EEPROM_SIZE))
     {
@@ -114,7 +120,6 @@ void setup()
     mqtt_task.begin();
 #endif
 
-    sensors_task_p->addStateListener(root_task.getSensorsStateQueue());
     sensors_task_p->begin();
 
     reset_task_p->begin();
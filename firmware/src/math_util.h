@@ -0,0 +1,17 @@
+#pragma once
+
+// Small numeric helpers with no Arduino/LVGL dependency, so code using them also builds for the native test env
+
+template <typename T>
+T CLAMP(const T &value, const T &low, const T &high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+#define COUNT_OF(A) (sizeof(A) / sizeof(A[0]))
+
+template <typename T>
+int sgn(T val)
+{
+    return (T(0) < val) - (val < T(0));
+}
@@ -0,0 +1,51 @@
+#include <Arduino.h>
+
+#include "angle_correction.h"
+
+static const float STEPS_PER_RADIAN = ANGLE_CORRECTION_SIZE / (2 * PI);
+
+AngleCorrection::AngleCorrection() {}
+
+void AngleCorrection::set(const float *table, pb_size_t count)
+{
+    if (count != ANGLE_CORRECTION_SIZE)
+    {
+        clear();
+        return;
+    }
+    memcpy(table_, table, ANGLE_CORRECTION_SIZE * sizeof(float));
+    table_[ANGLE_CORRECTION_SIZE] = table_[0];
+    enabled_ = true;
+}
+
+void AngleCorrection::clear()
+{
+    enabled_ = false;
+}
+
+float AngleCorrection::apply(float angle) const
+{
+    if (!enabled_)
+    {
+        return angle;
+    }
+
+    float x = angle * STEPS_PER_RADIAN;
+    uint8_t i = (uint8_t)x;
+    if (i >= ANGLE_CORRECTION_SIZE)
+    {
+        i = ANGLE_CORRECTION_SIZE - 1;
+    }
+    float error = table_[i] + (table_[i + 1] - table_[i]) * (x - i);
+
+    float corrected = angle - error;
+    if (corrected < 0)
+    {
+        corrected += 2 * PI;
+    }
+    else if (corrected >= 2 * PI)
+    {
+        corrected -= 2 * PI;
+    }
+    return corrected;
+}
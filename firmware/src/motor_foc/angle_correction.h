@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../proto_gen/smartknob.pb.h"
+
+static const uint8_t ANGLE_CORRECTION_SIZE = sizeof(PB_MotorCalibration::angle_correction) / sizeof(float);
+
+// Removes magnet eccentricity / sensor nonlinearity from a raw sensor angle using the error table measured during
+// motor calibration (see PB_MotorCalibration.angle_correction), with linear interpolation between table entries.
+class AngleCorrection
+{
+public:
+    AngleCorrection();
+
+    // A table that doesn't have exactly ANGLE_CORRECTION_SIZE entries disables correction.
+    void set(const float *table, pb_size_t count);
+    void clear();
+
+    // Takes and returns an angle in the range 0 to 2PI.
+    float apply(float angle) const;
+
+private:
+    bool enabled_ = false;
+    // Last entry repeats the first so interpolation can wrap around without a branch
+    float table_[ANGLE_CORRECTION_SIZE + 1] = {};
+};
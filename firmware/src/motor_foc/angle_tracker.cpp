@@ -0,0 +1,91 @@
+#include <math.h>
+
+#include "angle_tracker.h"
+
+static const float PI_F = M_PI;
+
+// Gaps longer than this (e.g. sensor errors) restart tracking from the next sample instead of slewing to it
+static const float MAX_UPDATE_INTERVAL_S = 0.01;
+// Timer jitter doesn't need new gains, the poles hardly move
+static const float GAINS_DT_TOLERANCE = 0.02;
+
+static float wrapAngle(float angle)
+{
+    if (angle >= 2 * PI_F)
+    {
+        return angle - 2 * PI_F;
+    }
+    if (angle < 0)
+    {
+        return angle + 2 * PI_F;
+    }
+    return angle;
+}
+
+AngleTracker::AngleTracker() {}
+
+void AngleTracker::setBandwidth(float bandwidth_hz, float damping)
+{
+    wn_ = 2 * PI_F * bandwidth_hz;
+    damping_ = damping;
+    gains_dt_ = 0;
+}
+
+void AngleTracker::updateGains(float dt)
+{
+    // Predict-correct with angle gain a and velocity gain b / dt has the characteristic polynomial
+    // z^2 - (2 - a - b) z + (1 - a). Matching it to poles p1, p2 (the continuous loop's poles mapped by exp(s * dt))
+    // gives a = 1 - p1 * p2 and b = (1 - p1) * (1 - p2), both in (0, 1) for any dt.
+    float decay = expf(-damping_ * wn_ * dt);
+    float pole_product = decay * decay;
+    float pole_sum;
+    if (damping_ < 1)
+    {
+        pole_sum = 2 * decay * cosf(wn_ * dt * sqrtf(1 - damping_ * damping_));
+    }
+    else
+    {
+        pole_sum = 2 * decay * coshf(wn_ * dt * sqrtf(damping_ * damping_ - 1));
+    }
+
+    angle_gain_ = 1 - pole_product;
+    velocity_gain_ = (1 - pole_sum + pole_product) / dt;
+    gains_dt_ = dt;
+}
+
+void AngleTracker::update(float measured_angle, float dt)
+{
+    if (!initialized_ || dt <= 0 || dt > MAX_UPDATE_INTERVAL_S)
+    {
+        angle_ = measured_angle;
+        velocity_ = 0;
+        initialized_ = true;
+        return;
+    }
+
+    if (fabsf(dt - gains_dt_) > GAINS_DT_TOLERANCE * gains_dt_)
+    {
+        updateGains(dt);
+    }
+
+    // Predict forward to the sample time, then correct with the phase error wrapped to (-PI, PI] so crossing zero
+    // doesn't look like a full turn
+    angle_ = wrapAngle(angle_ + velocity_ * dt);
+    float error = measured_angle - angle_;
+    if (error > PI_F)
+    {
+        error -= 2 * PI_F;
+    }
+    else if (error <= -PI_F)
+    {
+        error += 2 * PI_F;
+    }
+
+    angle_ = wrapAngle(angle_ + angle_gain_ * error);
+    velocity_ += velocity_gain_ * error;
+}
+
+float AngleTracker::angle(float dt) const
+{
+    return wrapAngle(angle_ + velocity_ * fminf(dt, MAX_UPDATE_INTERVAL_S));
+}
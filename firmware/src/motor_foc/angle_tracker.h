@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// Second order tracking loop (PLL) that estimates angle and velocity together from raw angle samples. Unlike an EWMA
+// on the angle it has no steady state lag at constant velocity, and its bandwidth is set directly in Hz.
+//
+// The loop is the continuous kp = 2 * zeta * wn, ki = wn^2 tracker, discretized exactly for each update interval (its
+// poles are placed at exp(s * dt)), so it stays stable however slowly it's updated. Applying kp/ki as a plain Euler step
+// diverges once wn * dt gets above ~0.8, e.g. a 300 Hz loop sampled at 1 kHz.
+class AngleTracker
+{
+public:
+    AngleTracker();
+
+    void setBandwidth(float bandwidth_hz, float damping = 1);
+
+    // Feed a measured angle (0 to 2PI) taken dt seconds after the previous one.
+    void update(float measured_angle, float dt);
+
+    // Estimated angle (0 to 2PI), extrapolated dt seconds past the last update.
+    float angle(float dt = 0) const;
+    // Estimated velocity in rad/s
+    float velocity() const
+    {
+        return velocity_;
+    }
+
+private:
+    float wn_ = 0;
+    float damping_ = 1;
+
+    // Gains for the update interval they were computed for; only recomputed when the interval changes noticeably
+    float gains_dt_ = 0;
+    float angle_gain_ = 0;
+    float velocity_gain_ = 0;
+
+    float angle_ = 0;
+    float velocity_ = 0;
+    bool initialized_ = false;
+
+    void updateGains(float dt);
+};
@@ -0,0 +1,183 @@
+#include <math.h>
+
+#include "detent_engine.h"
+#include "gain_schedule.h"
+#include "../math_util.h"
+
+static const float IDLE_VELOCITY_EWMA_ALPHA = 0.001;
+static const float IDLE_VELOCITY_RAD_PER_SEC = 0.05;
+static const uint32_t IDLE_CORRECTION_DELAY_US = 500000;
+static const float IDLE_CORRECTION_MAX_ANGLE_RAD = 5 * M_PI / 180;
+static const float IDLE_CORRECTION_RATE_ALPHA = 0.0005;
+
+// Don't apply torque if velocity is too high (helps avoid positive feedback loop/runaway)
+static const float MAX_TORQUE_VELOCITY_RAD_PER_SEC = 60;
+
+DetentEngine::DetentEngine(float torque_ramp) : torque_ramp_(torque_ramp)
+{
+    config_ = {
+        .position = 0,
+        .sub_position_unit = 0,
+        .position_nonce = 0,
+        .min_position = 0,
+        .max_position = 1,
+        .position_width_radians = 60 * M_PI / 180,
+        .detent_strength_unit = 0,
+    };
+    profile_.compile(config_);
+}
+
+const char *DetentEngine::validate(const PB_SmartKnobConfig &config)
+{
+    if (config.detent_strength_unit < 0)
+    {
+        return "detent_strength_unit cannot be negative";
+    }
+    if (config.endstop_strength_unit < 0)
+    {
+        return "endstop_strength_unit cannot be negative";
+    }
+    if (config.snap_point < 0.5)
+    {
+        return "snap_point must be >= 0.5 for stability";
+    }
+    if (config.detent_positions_count > COUNT_OF(config.detent_positions))
+    {
+        return "detent_positions_count is too large";
+    }
+    if (config.snap_point_bias < 0)
+    {
+        return "snap_point_bias cannot be negative or there is risk of instability";
+    }
+    return nullptr;
+}
+
+void DetentEngine::reset(float angle)
+{
+    position_ = 0;
+    sub_position_unit_ = 0;
+    detent_center_ = angle;
+    idle_check_velocity_ewma_ = 0;
+    idle_ = false;
+    last_torque_ = 0;
+    has_last_torque_ = false;
+}
+
+void DetentEngine::setConfig(const PB_SmartKnobConfig &config, float angle, const DetentIndex *detent_index)
+{
+    bool position_updated = false;
+    if (config.position != config_.position || config.sub_position_unit != config_.sub_position_unit || config.position_nonce != config_.position_nonce)
+    {
+        position_ = config.position;
+        position_updated = true;
+    }
+
+    if (config.min_position <= config.max_position)
+    {
+        // Only check bounds if min/max indicate bounds are active (min >= max)
+        position_ = CLAMP(position_, config.min_position, config.max_position);
+    }
+
+    if (position_updated || config.position_width_radians != config_.position_width_radians)
+    {
+        float new_sub_position = position_updated ? config.sub_position_unit : sub_position_unit_;
+        detent_center_ = angle + new_sub_position * config.position_width_radians;
+    }
+
+    config_ = config;
+    recompile(detent_index);
+}
+
+void DetentEngine::recompile(const DetentIndex *detent_index)
+{
+    detent_index_ = detent_index;
+    profile_.compile(config_, detent_index_, &gain_schedule_);
+}
+
+bool DetentEngine::setGainSchedule(const PB_GainSchedule &gain_schedule)
+{
+    bool valid = isValidGainSchedule(gain_schedule);
+    gain_schedule_ = valid ? gain_schedule : PB_GainSchedule{};
+    recompile(detent_index_);
+    return valid;
+}
+
+void DetentEngine::updateIdleCorrection(float angle, float velocity, uint32_t now_us)
+{
+    // If we are not moving and we're close to the center (but not exactly there), slowly adjust the centerpoint to match the current position
+    idle_check_velocity_ewma_ = velocity * IDLE_VELOCITY_EWMA_ALPHA + idle_check_velocity_ewma_ * (1 - IDLE_VELOCITY_EWMA_ALPHA);
+    if (fabsf(idle_check_velocity_ewma_) > IDLE_VELOCITY_RAD_PER_SEC)
+    {
+        idle_ = false;
+    }
+    else if (!idle_)
+    {
+        idle_ = true;
+        idle_start_us_ = now_us;
+    }
+    if (idle_ && now_us - idle_start_us_ > IDLE_CORRECTION_DELAY_US && fabsf(angle - detent_center_) < IDLE_CORRECTION_MAX_ANGLE_RAD)
+    {
+        detent_center_ = angle * IDLE_CORRECTION_RATE_ALPHA + detent_center_ * (1 - IDLE_CORRECTION_RATE_ALPHA);
+    }
+}
+
+float DetentEngine::rampLimit(float torque, uint32_t now_us)
+{
+    // Limit how quickly the detent torque can change, like the output ramp of the PID controller this replaced
+    float dt = has_last_torque_ ? (now_us - last_torque_us_) * 1e-6f : 0;
+    if (dt <= 0 || dt > 0.5f)
+    {
+        dt = 1e-3f;
+    }
+    float max_torque_step = torque_ramp_ * dt;
+    torque = CLAMP(torque, last_torque_ - max_torque_step, last_torque_ + max_torque_step);
+    last_torque_ = torque;
+    last_torque_us_ = now_us;
+    has_last_torque_ = true;
+    return torque;
+}
+
+DetentOutput DetentEngine::update(float angle, float velocity, uint32_t now_us)
+{
+    updateIdleCorrection(angle, velocity, now_us);
+
+    // Check where we are relative to the current nearest detent; update our position if we've moved far enough to snap to another detent
+    float angle_to_detent_center = angle - detent_center_;
+    if (angle_to_detent_center > profile_.snapDecrease(position_) && (!profile_.isBounded() || position_ > config_.min_position))
+    {
+        detent_center_ += profile_.width();
+        angle_to_detent_center -= profile_.width();
+        position_--;
+    }
+    else if (angle_to_detent_center < profile_.snapIncrease(position_) && (!profile_.isBounded() || position_ < config_.max_position))
+    {
+        detent_center_ -= profile_.width();
+        angle_to_detent_center += profile_.width();
+        position_++;
+    }
+
+    sub_position_unit_ = -angle_to_detent_center * profile_.inverseWidth();
+
+    bool out_of_bounds = profile_.isBounded() && ((angle_to_detent_center > 0 && position_ == config_.min_position) || (angle_to_detent_center < 0 && position_ == config_.max_position));
+
+    // Apply torque based on our angle to the nearest detent (detent strength, damping, etc is precompiled into the profile)
+    float torque = 0;
+    if (fabsf(velocity) <= MAX_TORQUE_VELOCITY_RAD_PER_SEC)
+    {
+        if (out_of_bounds)
+        {
+            torque = profile_.endstopTorque(angle_to_detent_center, velocity);
+        }
+        else if (!profile_.hasMagneticDetents() || profile_.isMagneticDetent(position_))
+        {
+            torque = profile_.detentTorque(angle_to_detent_center, velocity);
+        }
+        torque = rampLimit(torque, now_us);
+    }
+
+    return {
+        .torque = torque,
+        .position = position_,
+        .sub_position_unit = sub_position_unit_,
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../proto_gen/smartknob.pb.h"
+#include "detent_index.h"
+#include "detent_profile.h"
+
+struct DetentOutput
+{
+    float torque;
+    int32_t position;
+    float sub_position_unit;
+};
+
+// The detent state machine (snapping, bounds, idle re-centering and torque) with no dependency on the motor, sensor
+// or RTOS. Angles and velocities are in the knob's frame, i.e. already inverted if SK_INVERT_ROTATION is set, and the
+// returned torque is in the same frame.
+class DetentEngine
+{
+public:
+    // torque_ramp limits how fast the detent torque may change, in torque units per second
+    explicit DetentEngine(float torque_ramp);
+
+    // Returns a description of the first problem with config, or nullptr if it can be applied.
+    static const char *validate(const PB_SmartKnobConfig &config);
+
+    // Start over at position 0 with the current detent centered on angle.
+    void reset(float angle);
+
+    // Apply a (validated) config. A changed position/sub-position/nonce or detent width moves the detent center so the
+    // knob stays where it is physically.
+    void setConfig(const PB_SmartKnobConfig &config, float angle, const DetentIndex *detent_index = nullptr);
+    // Recompile the current config, e.g. after the detent index it points at changed.
+    void recompile(const DetentIndex *detent_index);
+    // Replace the detent gain schedule (an empty schedule restores the defaults) and recompile. An invalid schedule also
+    // restores the defaults and returns false.
+    bool setGainSchedule(const PB_GainSchedule &gain_schedule);
+
+    const PB_SmartKnobConfig &config() const
+    {
+        return config_;
+    }
+    int32_t position() const
+    {
+        return position_;
+    }
+    float subPositionUnit() const
+    {
+        return sub_position_unit_;
+    }
+
+    // Advance one detent tick.
+    DetentOutput update(float angle, float velocity, uint32_t now_us);
+
+private:
+    const float torque_ramp_;
+
+    PB_SmartKnobConfig config_;
+    DetentProfile profile_;
+    const DetentIndex *detent_index_ = nullptr;
+    PB_GainSchedule gain_schedule_ = {};
+
+    int32_t position_ = 0;
+    float sub_position_unit_ = 0;
+    float detent_center_ = 0;
+
+    float idle_check_velocity_ewma_ = 0;
+    bool idle_ = false;
+    uint32_t idle_start_us_ = 0;
+
+    float last_torque_ = 0;
+    uint32_t last_torque_us_ = 0;
+    bool has_last_torque_ = false;
+
+    void updateIdleCorrection(float angle, float velocity, uint32_t now_us);
+    float rampLimit(float torque, uint32_t now_us);
+};
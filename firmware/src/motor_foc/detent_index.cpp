@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <string.h>
+
+#include "detent_index.h"
+
+DetentIndex::DetentIndex() {}
+
+void DetentIndex::clear()
+{
+    config_id_[0] = '\0';
+    total_ = 0;
+    received_ = 0;
+    range_start_ = 0;
+    range_step_ = 0;
+}
+
+bool DetentIndex::applyChunk(const PB_DetentPositions &chunk)
+{
+    if (chunk.offset == 0)
+    {
+        clear();
+        if (chunk.range_step == 0 && chunk.total > DETENT_INDEX_MAX_POSITIONS)
+        {
+            return false;
+        }
+        strncpy(config_id_, chunk.config_id, sizeof(config_id_) - 1);
+        total_ = chunk.total;
+        range_start_ = chunk.range_start;
+        range_step_ = chunk.range_step;
+        if (range_step_ != 0)
+        {
+            // A range rule is complete as soon as it arrives
+            received_ = total_;
+            return true;
+        }
+    }
+    else if (chunk.offset != received_ || chunk.total != total_ || range_step_ != 0 || !matches(chunk.config_id))
+    {
+        return false;
+    }
+
+    if (chunk.positions_count > total_ - received_)
+    {
+        clear();
+        return false;
+    }
+    memcpy(&positions_[received_], chunk.positions, chunk.positions_count * sizeof(int32_t));
+    received_ += chunk.positions_count;
+
+    if (received_ == total_)
+    {
+        std::sort(positions_, positions_ + total_);
+    }
+    return true;
+}
+
+bool DetentIndex::matches(const char *config_id) const
+{
+    return strncmp(config_id_, config_id, sizeof(config_id_)) == 0;
+}
+
+bool DetentIndex::contains(int32_t position) const
+{
+    if (range_step_ != 0)
+    {
+        int64_t delta = (int64_t)position - range_start_;
+        if (delta % range_step_ != 0)
+        {
+            return false;
+        }
+        int64_t index = delta / range_step_;
+        return index >= 0 && index < total_;
+    }
+    return std::binary_search(positions_, positions_ + total_, position);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../proto_gen/smartknob.pb.h"
+
+// Largest explicit (non-range) magnetic detent set that can be uploaded
+static const uint16_t DETENT_INDEX_MAX_POSITIONS = 512;
+
+// Magnetic detent set uploaded in chunks via PB_DetentPositions, for sets too large for
+// PB_SmartKnobConfig.detent_positions. Explicit positions are kept sorted for O(log n) lookup, range rules are
+// checked in O(1).
+class DetentIndex
+{
+public:
+    DetentIndex();
+
+    void clear();
+
+    // Apply the next chunk of an upload; a chunk with offset 0 starts a new set. Returns false if the chunk doesn't
+    // continue the current upload or the set is too large.
+    bool applyChunk(const PB_DetentPositions &chunk);
+
+    bool isComplete() const
+    {
+        return received_ == total_ && config_id_[0] != '\0';
+    }
+    bool matches(const char *config_id) const;
+    uint32_t size() const
+    {
+        return total_;
+    }
+
+    bool contains(int32_t position) const;
+
+private:
+    char config_id_[sizeof(PB_DetentPositions::config_id)] = {};
+    uint32_t total_ = 0;
+    uint32_t received_ = 0;
+    int32_t range_start_ = 0;
+    int32_t range_step_ = 0;
+    int32_t positions_[DETENT_INDEX_MAX_POSITIONS] = {};
+};
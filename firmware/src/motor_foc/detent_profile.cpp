@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include "detent_profile.h"
+#include "gain_schedule.h"
+#include "../math_util.h"
+
+static const float DEAD_ZONE_DETENT_PERCENT = 0.2;
+static const float DEAD_ZONE_RAD = 1 * M_PI / 180;
+
+static const float STRENGTH_TO_GAIN = 4;
+
+DetentProfile::DetentProfile() {}
+
+void DetentProfile::compile(const PB_SmartKnobConfig &config, const DetentIndex *detent_index, const PB_GainSchedule *gain_schedule)
+{
+    width_ = config.position_width_radians;
+    inverse_width_ = 1 / width_;
+    bounded_ = config.max_position - config.min_position + 1 > 0;
+
+    float snap_point_radians = width_ * config.snap_point;
+    float bias_radians = width_ * config.snap_point_bias;
+    snap_decrease_low_ = snap_point_radians + bias_radians;
+    snap_decrease_high_ = snap_point_radians - bias_radians;
+    snap_increase_high_ = -snap_point_radians - bias_radians;
+    snap_increase_low_ = -snap_point_radians + bias_radians;
+
+    detent_positions_count_ = std::min(config.detent_positions_count, (pb_size_t)COUNT_OF(detent_positions_));
+    memcpy(detent_positions_, config.detent_positions, detent_positions_count_ * sizeof(int32_t));
+    std::sort(detent_positions_, detent_positions_ + detent_positions_count_);
+    detent_index_ = detent_index;
+
+    dead_zone_min_ = fmaxf(-width_ * DEAD_ZONE_DETENT_PERCENT, -DEAD_ZONE_RAD);
+    dead_zone_max_ = fminf(width_ * DEAD_ZONE_DETENT_PERCENT, DEAD_ZONE_RAD);
+
+    // P, D and the torque limit come from the (per unit) gain schedule, resolved once here rather than every tick
+    DetentGains gains = resolveDetentGains(gain_schedule, width_);
+    endstop_gain_ = config.endstop_strength_unit * STRENGTH_TO_GAIN;
+    torque_limit_ = gains.torque_limit;
+
+    // When there are intermittent detents (set via detent_positions), disable damping as this adds extra "clicks" when nearing
+    // a detent.
+    damping_ = hasMagneticDetents() ? 0 : config.detent_strength_unit * gains.d;
+
+    // The rotor never sits further from the detent center than the widest snap point before snapping to the neighbour
+    // (only an endstop lets it go further, and that's handled by endstopTorque), so the table only needs to span that.
+    table_span_ = fmaxf(fabsf(snap_decrease_low_), fabsf(snap_increase_high_));
+    float step = 2 * table_span_ / (DETENT_PROFILE_TABLE_SIZE - 1);
+    table_inverse_step_ = step > 0 ? 1 / step : 0;
+
+    float detent_gain = config.detent_strength_unit * gains.p;
+    for (uint16_t i = 0; i < DETENT_PROFILE_TABLE_SIZE; i++)
+    {
+        table_[i] = detent_gain * deadZoneInput(-table_span_ + i * step);
+    }
+}
+
+bool DetentProfile::isMagneticDetent(int32_t position) const
+{
+    if (detent_index_ != nullptr)
+    {
+        return detent_index_->contains(position);
+    }
+    return std::binary_search(detent_positions_, detent_positions_ + detent_positions_count_, position);
+}
+
+float DetentProfile::detentTorque(float angle_to_detent_center, float velocity) const
+{
+    float x = (angle_to_detent_center + table_span_) * table_inverse_step_;
+    float torque;
+    if (x <= 0)
+    {
+        torque = table_[0];
+    }
+    else if (x >= DETENT_PROFILE_TABLE_SIZE - 1)
+    {
+        torque = table_[DETENT_PROFILE_TABLE_SIZE - 1];
+    }
+    else
+    {
+        uint16_t i = (uint16_t)x;
+        float frac = x - i;
+        torque = table_[i] + (table_[i + 1] - table_[i]) * frac;
+    }
+
+    // The dead zone has a constant (zero) input, so only damp outside of it
+    if (angle_to_detent_center < dead_zone_min_ || angle_to_detent_center > dead_zone_max_)
+    {
+        torque -= damping_ * velocity;
+    }
+    return limit(torque);
+}
+
+float DetentProfile::endstopTorque(float angle_to_detent_center, float velocity) const
+{
+    return limit(endstop_gain_ * deadZoneInput(angle_to_detent_center) - damping_ * velocity);
+}
+
+float DetentProfile::deadZoneInput(float angle_to_detent_center) const
+{
+    return -angle_to_detent_center + CLAMP(angle_to_detent_center, dead_zone_min_, dead_zone_max_);
+}
+
+float DetentProfile::limit(float torque) const
+{
+    return CLAMP(torque, -torque_limit_, torque_limit_);
+}
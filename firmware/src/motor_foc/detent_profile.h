@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../proto_gen/smartknob.pb.h"
+#include "detent_index.h"
+
+// Number of samples in the angle -> torque table spanning one detent (odd so the detent center is an exact sample)
+static const uint16_t DETENT_PROFILE_TABLE_SIZE = 65;
+
+// A PB_SmartKnobConfig compiled into everything the control loop needs per tick: snap thresholds, bounds, a
+// torque-vs-angle table for a single detent and the damping gain. Compiling happens once per config change so the
+// hot loop only does a table interpolation plus damping.
+class DetentProfile
+{
+public:
+    DetentProfile();
+
+    // detent_index, if given, replaces config.detent_positions as the magnetic detent set and must outlive the profile
+    // (recompile whenever it changes). gain_schedule overrides the default detent gains and is only read while compiling.
+    void compile(const PB_SmartKnobConfig &config, const DetentIndex *detent_index = nullptr, const PB_GainSchedule *gain_schedule = nullptr);
+
+    // Angle (relative to the current detent center) past which the position decrements/increments.
+    float snapDecrease(int32_t position) const
+    {
+        return position <= 0 ? snap_decrease_low_ : snap_decrease_high_;
+    }
+    float snapIncrease(int32_t position) const
+    {
+        return position >= 0 ? snap_increase_high_ : snap_increase_low_;
+    }
+
+    bool isBounded() const
+    {
+        return bounded_;
+    }
+    float width() const
+    {
+        return width_;
+    }
+    float inverseWidth() const
+    {
+        return inverse_width_;
+    }
+
+    // Magnetic detent mode: only the listed positions pull the knob in, everything in between is free-spinning.
+    bool hasMagneticDetents() const
+    {
+        return detent_index_ != nullptr || detent_positions_count_ > 0;
+    }
+    bool isMagneticDetent(int32_t position) const;
+
+    // Torque pulling back to the detent center, with damping applied from the knob velocity.
+    float detentTorque(float angle_to_detent_center, float velocity) const;
+    // Torque pushing back into the valid range when past min/max.
+    float endstopTorque(float angle_to_detent_center, float velocity) const;
+
+private:
+    float width_ = 1;
+    float inverse_width_ = 1;
+    bool bounded_ = false;
+
+    float snap_decrease_low_ = 0;
+    float snap_decrease_high_ = 0;
+    float snap_increase_low_ = 0;
+    float snap_increase_high_ = 0;
+
+    float dead_zone_min_ = 0;
+    float dead_zone_max_ = 0;
+
+    float endstop_gain_ = 0;
+    float damping_ = 0;
+    float torque_limit_ = 0;
+
+    // Sorted copy of config.detent_positions for binary search
+    int32_t detent_positions_[sizeof(PB_SmartKnobConfig::detent_positions) / sizeof(int32_t)] = {};
+    pb_size_t detent_positions_count_ = 0;
+    const DetentIndex *detent_index_ = nullptr;
+
+    float table_span_ = 0;
+    float table_inverse_step_ = 0;
+    float table_[DETENT_PROFILE_TABLE_SIZE] = {};
+
+    float deadZoneInput(float angle_to_detent_center) const;
+    float limit(float torque) const;
+};
@@ -0,0 +1,81 @@
+#include <math.h>
+#include <stdint.h>
+
+#include "fast_math.h"
+
+static const float PI_F = M_PI;
+
+static const uint16_t SIN_TABLE_SIZE = 256;
+static const uint16_t QUARTER_TURN = SIN_TABLE_SIZE / 4;
+static const float TABLE_STEPS_PER_RADIAN = SIN_TABLE_SIZE / (2 * PI_F);
+
+// Last entry repeats the first so interpolation can wrap around without a branch
+static float sin_table[SIN_TABLE_SIZE + 1];
+
+static struct SinTableInit
+{
+    SinTableInit()
+    {
+        for (uint16_t i = 0; i <= SIN_TABLE_SIZE; i++)
+        {
+            sin_table[i] = sinf(i * 2 * PI_F / SIN_TABLE_SIZE);
+        }
+    }
+} sin_table_init;
+
+static inline float lookup(uint16_t index, float frac)
+{
+    return sin_table[index] + (sin_table[index + 1] - sin_table[index]) * frac;
+}
+
+void fastSinCos(float angle, float *sin_out, float *cos_out)
+{
+    float x = angle * TABLE_STEPS_PER_RADIAN;
+    float whole = floorf(x);
+    float frac = x - whole;
+    uint16_t index = (uint16_t)((int32_t)whole & (SIN_TABLE_SIZE - 1));
+
+    *sin_out = lookup(index, frac);
+    *cos_out = lookup((index + QUARTER_TURN) & (SIN_TABLE_SIZE - 1), frac);
+}
+
+float fastSin(float angle)
+{
+    float s, c;
+    fastSinCos(angle, &s, &c);
+    return s;
+}
+
+float fastCos(float angle)
+{
+    float s, c;
+    fastSinCos(angle, &s, &c);
+    return c;
+}
+
+float fastAtan2(float y, float x)
+{
+    float abs_x = fabsf(x);
+    float abs_y = fabsf(y);
+    if (abs_x == 0 && abs_y == 0)
+    {
+        return 0;
+    }
+
+    // Reduce to the first octant so the polynomial only has to cover atan(z) for z in [0, 1]
+    bool steep = abs_y > abs_x;
+    float z = steep ? abs_x / abs_y : abs_y / abs_x;
+    float z2 = z * z;
+    float angle = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+
+    if (steep)
+    {
+        angle = PI_F / 2 - angle;
+    }
+    if (x < 0)
+    {
+        angle = PI_F - angle;
+    }
+    // Like atan2f, the sign follows y's sign bit, so -0 on the negative x axis gives -PI
+    return copysignf(angle, y);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Table/polynomial based trig for the sensor read path, which runs at the FOC rate. Measured against libm over the
+// full input range:
+//  - fastSin/fastCos/fastSinCos: 256 entry table with linear interpolation, absolute error < 8e-5 (h^2/8 with
+//    h = 2PI/256). Accepts any finite angle.
+//  - fastAtan2: octant reduction plus a 9th order odd polynomial (Abramowitz & Stegun 4.4.49), absolute error
+//    < 1.2e-5 rad. Same range and conventions as atan2f, including signed zero (-PI for (-0, x < 0)), except that
+//    (+-0, +-0) always gives 0.
+// Both are well below the 14-bit MT6701 resolution (3.8e-4 rad).
+
+float fastSin(float angle);
+float fastCos(float angle);
+void fastSinCos(float angle, float *sin_out, float *cos_out);
+float fastAtan2(float y, float x);
@@ -0,0 +1,80 @@
+#include <math.h>
+
+#include "gain_schedule.h"
+
+// Damping based on detent width.
+// If the D factor is large on coarse detents, the motor ends up making noise because the P&D factors amplify the noise from the sensor.
+// This is a piecewise linear function so that fine detents (small width) get a higher D factor and coarse detents get a small D factor.
+// Fine detents need a nonzero D factor to artificially create "clicks" each time a new value is reached (the P factor is small
+// for fine detents due to the smaller angular errors, and the existing P factor doesn't work well for very small angle changes (easy to
+// get runaway due to sensor noise & lag)).
+static const PB_GainSchedule DEFAULT_GAIN_SCHEDULE = {
+    .entries_count = 2,
+    .entries = {
+        {
+            .position_width_radians = 3 * M_PI / 180,
+            .p = 4,
+            .d = 0.08,
+            .torque_limit = 10,
+        },
+        {
+            .position_width_radians = 8 * M_PI / 180,
+            .p = 4,
+            .d = 0.02,
+            .torque_limit = 10,
+        },
+    },
+};
+
+static const float MAX_TORQUE_LIMIT = 10;
+
+DetentGains resolveDetentGains(const PB_GainSchedule *schedule, float position_width_radians)
+{
+    if (schedule == nullptr || schedule->entries_count == 0)
+    {
+        schedule = &DEFAULT_GAIN_SCHEDULE;
+    }
+
+    const PB_GainScheduleEntry *entries = schedule->entries;
+    const pb_size_t count = schedule->entries_count;
+    if (position_width_radians <= entries[0].position_width_radians)
+    {
+        return {entries[0].p, entries[0].d, entries[0].torque_limit};
+    }
+    for (pb_size_t i = 1; i < count; i++)
+    {
+        const PB_GainScheduleEntry &low = entries[i - 1];
+        const PB_GainScheduleEntry &high = entries[i];
+        if (position_width_radians < high.position_width_radians)
+        {
+            float t = (position_width_radians - low.position_width_radians) / (high.position_width_radians - low.position_width_radians);
+            return {
+                .p = low.p + (high.p - low.p) * t,
+                .d = low.d + (high.d - low.d) * t,
+                .torque_limit = low.torque_limit + (high.torque_limit - low.torque_limit) * t,
+            };
+        }
+    }
+    return {entries[count - 1].p, entries[count - 1].d, entries[count - 1].torque_limit};
+}
+
+bool isValidGainSchedule(const PB_GainSchedule &schedule)
+{
+    if (schedule.entries_count > sizeof(schedule.entries) / sizeof(schedule.entries[0]))
+    {
+        return false;
+    }
+    for (pb_size_t i = 0; i < schedule.entries_count; i++)
+    {
+        const PB_GainScheduleEntry &entry = schedule.entries[i];
+        if (!(entry.position_width_radians > 0) || !(entry.p >= 0) || !(entry.d >= 0) || !(entry.torque_limit > 0 && entry.torque_limit <= MAX_TORQUE_LIMIT))
+        {
+            return false;
+        }
+        if (i > 0 && !(entry.position_width_radians > schedule.entries[i - 1].position_width_radians))
+        {
+            return false;
+        }
+    }
+    return true;
+}
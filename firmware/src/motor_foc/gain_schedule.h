@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../proto_gen/smartknob.pb.h"
+
+// Detent controller gains per unit of detent strength
+struct DetentGains
+{
+    float p;
+    float d;
+    float torque_limit;
+};
+
+// Gains for the given detent width, interpolated from schedule (or the built-in defaults if schedule is null/empty).
+DetentGains resolveDetentGains(const PB_GainSchedule *schedule, float position_width_radians);
+
+// Whether schedule can be used: entries sorted by strictly increasing width, with sane gains.
+bool isValidGainSchedule(const PB_GainSchedule &schedule);
@@ -0,0 +1,117 @@
+#include <string.h>
+
+#include "haptic_sequencer.h"
+
+// A quick burst of torque in each direction; at ~1ms per sample this matches the legacy 3-tick click.
+static const int8_t CLICK_SAMPLES[] = {127, 127, 127, -127, -127, -127};
+
+static const int8_t DOUBLE_CLICK_SAMPLES[] = {
+    127, 127, 127, -127, -127, -127,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    127, 127, 127, -127, -127, -127};
+
+// ~250Hz square wave
+static const int8_t BUZZ_SAMPLES[] = {
+    127, 127, -127, -127, 127, 127, -127, -127,
+    127, 127, -127, -127, 127, 127, -127, -127,
+    127, 127, -127, -127, 127, 127, -127, -127,
+    127, 127, -127, -127, 127, 127, -127, -127,
+    127, 127, -127, -127, 127, 127, -127, -127};
+
+static const int8_t RAMP_SAMPLES[] = {
+    4, 8, 12, 16, 20, 24, 28, 32,
+    36, 40, 44, 48, 52, 56, 60, 64,
+    68, 72, 76, 80, 84, 88, 92, 96,
+    100, 104, 108, 112, 116, 120, 124, 127,
+    -127, -127, -127};
+
+struct BuiltinWaveform
+{
+    const int8_t *samples;
+    uint8_t length;
+};
+
+static const BuiltinWaveform BUILTIN_WAVEFORMS[] = {
+    {CLICK_SAMPLES, sizeof(CLICK_SAMPLES)},
+    {DOUBLE_CLICK_SAMPLES, sizeof(DOUBLE_CLICK_SAMPLES)},
+    {BUZZ_SAMPLES, sizeof(BUZZ_SAMPLES)},
+    {RAMP_SAMPLES, sizeof(RAMP_SAMPLES)},
+};
+
+static const uint8_t BUILTIN_WAVEFORM_COUNT = sizeof(BUILTIN_WAVEFORMS) / sizeof(BUILTIN_WAVEFORMS[0]);
+
+HapticSequencer::HapticSequencer() {}
+
+void HapticSequencer::play(HapticWaveform waveform, float strength, uint8_t sample_ticks)
+{
+    uint8_t id = static_cast<uint8_t>(waveform);
+    if (id < BUILTIN_WAVEFORM_COUNT)
+    {
+        samples_ = BUILTIN_WAVEFORMS[id].samples;
+        length_ = BUILTIN_WAVEFORMS[id].length;
+    }
+    else if (id - BUILTIN_WAVEFORM_COUNT < HAPTIC_USER_WAVEFORM_COUNT)
+    {
+        const HapticWaveformData &user = user_waveforms_[id - BUILTIN_WAVEFORM_COUNT];
+        samples_ = user.samples;
+        length_ = user.length;
+    }
+    else
+    {
+        stop();
+        return;
+    }
+
+    index_ = 0;
+    hold_ = 0;
+    sample_ticks_ = sample_ticks == 0 ? 1 : sample_ticks;
+    scale_ = strength / 127;
+}
+
+void HapticSequencer::stop()
+{
+    samples_ = nullptr;
+    length_ = 0;
+    index_ = 0;
+}
+
+bool HapticSequencer::isPlaying() const
+{
+    return index_ < length_;
+}
+
+bool HapticSequencer::setUserWaveform(uint8_t slot, const int8_t *samples, uint8_t length)
+{
+    if (slot >= HAPTIC_USER_WAVEFORM_COUNT || length > HAPTIC_MAX_SAMPLES)
+    {
+        return false;
+    }
+
+    HapticWaveformData &user = user_waveforms_[slot];
+    // Don't swap the samples out from under a playing waveform
+    if (samples_ == user.samples)
+    {
+        stop();
+    }
+    memcpy(user.samples, samples, length);
+    user.length = length;
+    return true;
+}
+
+float HapticSequencer::tick()
+{
+    if (index_ >= length_)
+    {
+        return 0;
+    }
+
+    float torque = samples_[index_] * scale_;
+    if (++hold_ >= sample_ticks_)
+    {
+        hold_ = 0;
+        index_++;
+    }
+    return torque;
+}
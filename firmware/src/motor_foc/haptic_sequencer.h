@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// Maximum number of samples in a single waveform (one sample per detent stage tick, ~1ms)
+static const uint8_t HAPTIC_MAX_SAMPLES = 64;
+static const uint8_t HAPTIC_USER_WAVEFORM_COUNT = 4;
+
+enum class HapticWaveform : uint8_t
+{
+    CLICK,
+    DOUBLE_CLICK,
+    BUZZ,
+    RAMP,
+    USER_0,
+    USER_1,
+    USER_2,
+    USER_3,
+};
+
+struct HapticWaveformData
+{
+    uint8_t length;
+    // Normalized torque, -127..127 maps to -strength..strength
+    int8_t samples[HAPTIC_MAX_SAMPLES];
+};
+
+// Plays torque waveforms one sample per control tick so that haptic effects can be mixed additively with the
+// detent torque instead of taking over the motor loop.
+class HapticSequencer
+{
+public:
+    HapticSequencer();
+
+    // Start playing a waveform, replacing whatever is currently playing. Each sample is held for sample_ticks ticks.
+    void play(HapticWaveform waveform, float strength, uint8_t sample_ticks = 1);
+    void stop();
+    bool isPlaying() const;
+
+    bool setUserWaveform(uint8_t slot, const int8_t *samples, uint8_t length);
+
+    // Advance by one control tick and return the torque to add for this tick.
+    float tick();
+
+private:
+    const int8_t *samples_ = nullptr;
+    uint8_t length_ = 0;
+    uint8_t index_ = 0;
+    uint8_t sample_ticks_ = 1;
+    uint8_t hold_ = 0;
+    float scale_ = 0;
+
+    HapticWaveformData user_waveforms_[HAPTIC_USER_WAVEFORM_COUNT] = {};
+};
@@ -10,24 +10,103 @@
 #endif
 
 #include "../motors/motor_config.h"
+#include "../semaphore_guard.h"
 #include "../util.h"
+#include "angle_correction.h"
+#include "gain_schedule.h"
+
+// Calibration turns the field continuously in open loop and fits the motor parameters to all the samples afterwards
+static const float CALIBRATION_SWEEP_STEP_RAD = 0.02; // electrical, per ~1ms
+static const float CALIBRATION_SWEEP_MECHANICAL_RAD = 1.05 * _2PI;
+// More than 12 pole pairs' worth of sweep without a full revolution means the rotor isn't following the field
+static const float CALIBRATION_MAX_ELECTRICAL_RAD = 13 * _2PI;
+static const float CALIBRATION_SKIP_ELECTRICAL_RAD = _PI;
+static const uint16_t CALIBRATION_SETTLE_MILLIS = 200;
+static const uint8_t CALIBRATION_SAMPLE_DIVIDER = 4;
+static const uint16_t CALIBRATION_MAX_SAMPLES = 2048;
+static const uint16_t CALIBRATION_MIN_SAMPLES = 64;
+static const uint32_t CALIBRATION_REPORT_INTERVAL_MILLIS = 100;
+
+struct CalibrationSample
+{
+    float electrical;
+    float mechanical;
+};
+
+// Autotune runs a PD step response at each of these detent widths and bisects D until the overshoot hits the target
+static const float AUTOTUNE_WIDTHS_DEGREES[] = {2, 3, 5, 8, 15, 30};
+static const float AUTOTUNE_STRENGTH = 1;
+static const float AUTOTUNE_P = 4;
+static const float AUTOTUNE_TORQUE_LIMIT = 10;
+static const float AUTOTUNE_MAX_D = 0.2;
+static const float AUTOTUNE_TARGET_OVERSHOOT = 0.1;
+static const uint8_t AUTOTUNE_ITERATIONS = 6;
+static const uint16_t AUTOTUNE_SETTLE_MILLIS = 150;
+static const uint16_t AUTOTUNE_RESPONSE_MILLIS = 250;
+// If the rotor covers less than this fraction of the step (e.g. stuck on cogging), the width can't be tuned
+static const float AUTOTUNE_MIN_RESPONSE = 0.25;
+
+static const uint32_t PUBLISH_SUB_POSITION_INTERVAL_MILLIS = 5;
+static const float PUBLISH_SUB_POSITION_THRESHOLD = 0.01;
+static const uint32_t PUBLISH_HEARTBEAT_INTERVAL_MILLIS = 50;
+
+#if SK_MOTOR_THERMAL_LIMIT
+static const uint32_t THERMAL_REPORT_INTERVAL_MILLIS = 100;
+// Warn once the torque is noticeably derated, and again only after it has fully recovered
+static const float THERMAL_WARN_SCALE = 0.9;
+#endif
+
+#if SK_MOTOR_IDLE
+// Idle mode frees most of the FOC loop's CPU time (sensor reads, commutation) on the motor core while nobody is using
+// the knob; the detent stage keeps its rate. At rest the detent torque is ~0 in either mode, so the lower FOC rate by
+// itself doesn't save motor current: only the halved voltage limit does, by capping what a disturbance can draw while
+// idle. The detents are held at reduced strength, and rotating the knob faster than the wake velocity wakes it back up.
+static const float IDLE_MODE_VOLTAGE_SCALE = 0.5;
+static const float IDLE_MODE_WAKE_VELOCITY_RAD_PER_SEC = 0.5;
+// After waking from rotation, stay active for a while so RootTask has time to notice the interaction
+static const uint32_t IDLE_MODE_WAKE_HOLD_MILLIS = 2000;
+#endif
 
-static const float DEAD_ZONE_DETENT_PERCENT = 0.2;
-static const float DEAD_ZONE_RAD = 1 * _PI / 180;
+#if SK_MOTOR_LOOP_HZ
+// The FOC loop is paced by a hardware timer at SK_MOTOR_LOOP_HZ; the detent/PID stage (and everything else that used to
+// run once per delay(1) iteration) runs every SK_MOTOR_DETENT_DIVIDER FOC iterations so its tuning stays at ~1kHz.
+static const uint32_t LOOP_PERIOD_US = 1000000 / SK_MOTOR_LOOP_HZ;
+static const uint8_t LOOP_TIMER_INDEX = 0;
+static const uint16_t LOOP_TIMER_DIVIDER = 80; // 80MHz APB clock -> 1us timer resolution
+static const uint32_t LOOP_STATS_INTERVAL_MILLIS = 5000;
 
-static const float IDLE_VELOCITY_EWMA_ALPHA = 0.001;
-static const float IDLE_VELOCITY_RAD_PER_SEC = 0.05;
-static const uint32_t IDLE_CORRECTION_DELAY_MILLIS = 500;
-static const float IDLE_CORRECTION_MAX_ANGLE_RAD = 5 * PI / 180;
-static const float IDLE_CORRECTION_RATE_ALPHA = 0.0005;
+// Motor task needs to preempt everything else on its core as soon as the timer fires, otherwise the period jitters
+// by up to a full FreeRTOS tick whenever another task of the same priority is running.
+static const UBaseType_t MOTOR_TASK_PRIORITY = configMAX_PRIORITIES - 5;
+
+static TaskHandle_t loop_timer_task_ = NULL;
+
+static void IRAM_ATTR onLoopTimer()
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(loop_timer_task_, &higher_priority_task_woken);
+    if (higher_priority_task_woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+#else
+static const UBaseType_t MOTOR_TASK_PRIORITY = 1;
+#endif
 
-MotorTask::MotorTask(const uint8_t task_core, Configuration &configuration) : Task("Motor", 1024 * 5, 1, task_core), configuration_(configuration)
+MotorTask::MotorTask(const uint8_t task_core, Configuration &configuration, I2cBus &i2c_bus) : Task("Motor", 1024 * 5, MOTOR_TASK_PRIORITY, task_core), configuration_(configuration), i2c_bus_(i2c_bus)
 {
     queue_ = xQueueCreate(5, sizeof(Command));
     assert(queue_ != NULL);
+
+    config_mutex_ = xSemaphoreCreateMutex();
+    assert(config_mutex_ != NULL);
 }
 
-MotorTask::~MotorTask() {}
+MotorTask::~MotorTask()
+{
+    vSemaphoreDelete(config_mutex_);
+}
 
 #if SENSOR_TLV
 TlvSensor encoder = TlvSensor();
@@ -44,7 +123,7 @@ void MotorTask::run()
     driver.init();
 
 #if SENSOR_TLV
-    encoder.init(&Wire, false);
+    encoder.init(i2c_bus_, false);
 #elif SENSOR_MT6701
     encoder.init();
 #elif SENSOR_MAQ430
@@ -60,14 +139,6 @@ void MotorTask::run()
     motor.velocity_limit = 10000;
     motor.linkSensor(&encoder);
 
-    // Not actually using the velocity loop built into SimpleFOC; but I'm using those PID variables
-    // to run PID for torque (and SimpleFOC studio supports updating them easily over serial for tuning)
-    motor.PID_velocity.P = FOC_PID_P;
-    motor.PID_velocity.I = FOC_PID_I;
-    motor.PID_velocity.D = FOC_PID_D;
-    motor.PID_velocity.output_ramp = FOC_PID_OUTPUT_RAMP;
-    motor.PID_velocity.limit = FOC_PID_LIMIT;
-
 #ifdef FOC_LPF
     motor.LPF_angle.Tf = FOC_LPF;
 #endif
@@ -79,9 +150,6 @@ void MotorTask::run()
 
     PB_PersistentConfiguration c = configuration_.get();
 
-    motor.pole_pairs = c.motor.pole_pairs;
-    motor.sensor_direction = c.motor.direction_cw ? Direction::CW : Direction::CCW;
-
 #if DO_AUTOMATIC_MOTOR_CALIBRATION
     if (!c.motor.calibrated) // If the motor hasn't been calibrated, do it now
     {
@@ -95,312 +163,620 @@ void MotorTask::run()
     }
 #endif
 
-    motor.zero_electric_angle = c.motor.zero_electrical_offset;
-    motor.initFOC();
+    applyCalibration(c.motor);
 
     motor.monitor_downsample = 0; // disable monitor at first - optional
 
     // disableCore0WDT();
 
-    float current_detent_center = motor.shaft_angle;
-    PB_SmartKnobConfig config = {
-        .position = 0,
-        .sub_position_unit = 0,
-        .position_nonce = 0,
-        .min_position = 0,
-        .max_position = 1,
-        .position_width_radians = 60 * _PI / 180,
-        .detent_strength_unit = 0,
-    };
-    int32_t current_position = 0;
-    float latest_sub_position_unit = 0;
-
-    float idle_check_velocity_ewma = 0;
-    uint32_t last_idle_start = 0;
+    DetentEngine engine(FOC_PID_OUTPUT_RAMP);
+#if SK_INVERT_ROTATION
+    engine.reset(-motor.shaft_angle);
+#else
+    engine.reset(motor.shaft_angle);
+#endif
+    if (!engine.setGainSchedule(c.gain_schedule))
+    {
+        LOGW("Invalid gain schedule in configuration, using defaults");
+    }
+    setAppliedConfig(engine.config());
+#if SK_MOTOR_THERMAL_LIMIT
+    ThermalLimiter thermal(FOC_CONTINUOUS_VOLTAGE, FOC_VOLTAGE_LIMIT, FOC_THERMAL_CAPACITY_SECONDS);
+#endif
+    MotorState last_published = {};
+    bool has_published = false;
     uint32_t last_publish = 0;
+    uint32_t config_mailbox_generation = 0;
+    PB_SmartKnobConfig new_config;
+    HapticData haptic;
+
+#if SK_MOTOR_LOOP_HZ
+    startLoopTimer();
+
+    uint8_t foc_iterations = 0;
+    LoopTimingStats loop_stats = {};
+    uint32_t last_tick_us = 0;
+    uint32_t last_loop_stats = millis();
+#endif
+
+#if SK_MOTOR_TIMING
+#if SK_MOTOR_LOOP_HZ
+    const uint32_t nominal_period_us = LOOP_PERIOD_US;
+#else
+    const uint32_t nominal_period_us = 1000;
+#endif
+    // Histograms cover 0-2x the nominal period, and a few microseconds per bucket for the individual stages
+    timing_.setBucketWidthUs(MotorTimingStage::PERIOD, nominal_period_us * 2 / MOTOR_TIMING_BUCKETS);
+    timing_.setBucketWidthUs(MotorTimingStage::FOC, 5);
+    timing_.setBucketWidthUs(MotorTimingStage::COMMANDS, 2);
+    timing_.setBucketWidthUs(MotorTimingStage::DETENT, 2);
+    timing_.setBucketWidthUs(MotorTimingStage::PUBLISH, 10);
+    uint32_t last_tick_cycles = 0;
+    uint32_t stage_start_cycles;
+#endif
+
+#if SK_MOTOR_IDLE
+    uint32_t last_wake = millis();
+#if SK_MOTOR_LOOP_HZ
+    uint8_t idle_ticks = 0;
+#endif
+#endif
 
     while (1)
     {
+#if SK_MOTOR_LOOP_HZ
+        // Block until the hardware timer releases the next control period. A count > 1 means we overran and ticks were
+        // coalesced.
+        uint32_t pending_ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t now_us = micros();
+        if (last_tick_us != 0)
+        {
+            uint32_t period_us = now_us - last_tick_us;
+            loop_stats.min_period_us = loop_stats.samples == 0 ? period_us : min(loop_stats.min_period_us, period_us);
+            loop_stats.max_period_us = max(loop_stats.max_period_us, period_us);
+            loop_stats.samples++;
+        }
+        last_tick_us = now_us;
+        if (pending_ticks > 1)
+        {
+            loop_stats.missed_ticks += pending_ticks - 1;
+        }
+#else
+        delay(1);
+#endif
+
+#if SK_MOTOR_TIMING
+        stage_start_cycles = ESP.getCycleCount();
+        if (last_tick_cycles != 0)
+        {
+            timing_.record(MotorTimingStage::PERIOD, stage_start_cycles - last_tick_cycles);
+        }
+        last_tick_cycles = stage_start_cycles;
+#if SK_MOTOR_LOOP_HZ
+        if (pending_ticks > 1)
+        {
+            timing_.addMissedTicks(pending_ticks - 1);
+        }
+#endif
+#endif
+
+#if SK_MOTOR_IDLE && SK_MOTOR_LOOP_HZ
+        // Idle mode only runs FOC on every SK_MOTOR_IDLE_FOC_DIVIDER-th timer tick. The sensors' angle trackers derive their
+        // gains from the actual update interval, so their angle and velocity (which the wake check below relies on) stay
+        // stable at the reduced rate.
+        if (idle_ && ++idle_ticks < SK_MOTOR_IDLE_FOC_DIVIDER)
+        {
+            continue;
+        }
+        idle_ticks = 0;
+#endif
+
         motor.loopFOC();
 
-        // Check queue for pending requests from other tasks
-        Command command;
-        if (xQueueReceive(queue_, &command, 0) == pdTRUE)
+#if SK_MOTOR_TIMING
+        timing_.record(MotorTimingStage::FOC, ESP.getCycleCount() - stage_start_cycles);
+#endif
+
+#if SK_MOTOR_IDLE
+        // Wake up as soon as something engages the knob or it's turned, without waiting for the detent stage. This reads
+        // the sensor's velocity as of the loopFOC() above: motor.shaft_velocity is only refreshed by move() in the detent
+        // stage.
+        if (idle_ && (engaged_.load(std::memory_order_relaxed) || fabsf(encoder.getVelocity()) > IDLE_MODE_WAKE_VELOCITY_RAD_PER_SEC))
         {
-            if (!c.motor.calibrated && command.command_type != CommandType::CALIBRATE)
-            {
-                LOGI("Ignoring command, motor not calibrated!");
-                if (motor.enabled)
-                    motor.disable();
+            setIdle(false);
+            last_wake = millis();
+        }
+        else if (!idle_ && !engaged_.load(std::memory_order_relaxed) && !haptic_.isPlaying() && millis() - last_wake > IDLE_MODE_WAKE_HOLD_MILLIS)
+        {
+            setIdle(true);
+        }
+        else if (engaged_.load(std::memory_order_relaxed))
+        {
+            last_wake = millis();
+        }
+#endif
 
-                delay(1);
-                continue;
-            }
-            switch (command.command_type)
-            {
-            case CommandType::CALIBRATE:
-                if (!motor.enabled)
-                    motor.enable();
+#if SK_MOTOR_LOOP_HZ
+        // Count timer ticks rather than FOC iterations so the detent stage keeps its rate in idle mode
+#if SK_MOTOR_IDLE
+        foc_iterations += idle_ ? SK_MOTOR_IDLE_FOC_DIVIDER : 1;
+#else
+        foc_iterations++;
+#endif
+        if (foc_iterations < SK_MOTOR_DETENT_DIVIDER)
+        {
+            continue;
+        }
+        foc_iterations = 0;
+
+        if (millis() - last_loop_stats > LOOP_STATS_INTERVAL_MILLIS)
+        {
+            checkLoopTiming(loop_stats);
+            loop_stats = {};
+            last_loop_stats = millis();
+        }
+#endif
+
+#if SK_MOTOR_TIMING
+        stage_start_cycles = ESP.getCycleCount();
+#endif
+
+        // Check for pending requests from other tasks
+        bool run_calibration = calibration_requested_.exchange(false, std::memory_order_acquire);
+        bool run_autotune = autotune_requested_.exchange(false, std::memory_order_acquire) && !run_calibration;
+        if (run_autotune && !c.motor.calibrated)
+        {
+            LOGW("Ignoring autotune, motor not calibrated!");
+            run_autotune = false;
+        }
+        if (run_calibration || run_autotune)
+        {
+            if (!motor.enabled)
+                motor.enable();
 
+            if (run_calibration)
+            {
                 calibrate();
-                esp_restart(); // Restart to apply new calibration
-                break;
-            case CommandType::CONFIG:
+            }
+            else
             {
-                // Check new config for validity
-                PB_SmartKnobConfig &new_config = command.data.config;
-                if (new_config.detent_strength_unit < 0)
-                {
-                    LOGD("Ignoring invalid config: detent_strength_unit cannot be negative");
-                    break;
-                }
-                if (new_config.endstop_strength_unit < 0)
-                {
-                    LOGD("Ignoring invalid config: endstop_strength_unit cannot be negative");
-                    break;
-                }
-                if (new_config.snap_point < 0.5)
-                {
-                    LOGD("Ignoring invalid config: snap_point must be >= 0.5 for stability");
-                    break;
-                }
-                if (new_config.detent_positions_count > COUNT_OF(new_config.detent_positions))
-                {
-                    LOGD("Ignoring invalid config: detent_positions_count is too large");
-                    break;
-                }
-                if (new_config.snap_point_bias < 0)
-                {
-                    LOGD("Ignoring invalid config: snap_point_bias cannot be negative or there is risk of instability");
-                    break;
-                }
+                autotune();
+            }
 
-                // Change haptic input mode
-                bool position_updated = false;
-                if (new_config.position != config.position || new_config.sub_position_unit != config.sub_position_unit || new_config.position_nonce != config.position_nonce)
-                {
-                    LOGD("applying position change");
-                    current_position = new_config.position;
-                    position_updated = true;
-                }
+            // Switch to the new calibration/gains (or back to the previous ones if it failed) without rebooting
+            c = configuration_.get();
+            applyCalibration(c.motor);
+            engine.setGainSchedule(c.gain_schedule);
+#if SK_INVERT_ROTATION
+            engine.reset(-motor.shaftAngle());
+#else
+            engine.reset(motor.shaftAngle());
+#endif
+#if SK_MOTOR_IDLE
+            idle_ = false;
+            last_wake = millis();
+#endif
+#if SK_MOTOR_LOOP_HZ
+            // Drop the timer ticks that piled up while calibrating/tuning
+            ulTaskNotifyTake(pdTRUE, 0);
+            last_tick_us = 0;
+#endif
+#if SK_MOTOR_TIMING
+            last_tick_cycles = 0;
+#endif
+#if SK_MOTOR_THERMAL_LIMIT
+            last_thermal_us_ = 0;
+#endif
+            continue;
+        }
 
-                if (new_config.min_position <= new_config.max_position)
-                {
-                    // Only check bounds if min/max indicate bounds are active (min >= max)
-                    if (current_position < new_config.min_position)
-                    {
-                        current_position = new_config.min_position;
-                        LOGD("adjusting position to min");
-                    }
-                    else if (current_position > new_config.max_position)
-                    {
-                        current_position = new_config.max_position;
-                        LOGD("adjusting position to max");
-                    }
-                }
+        bool has_config = config_mailbox_.take(new_config, config_mailbox_generation);
+        bool has_haptic = haptic_ring_.pop(haptic);
+        Command command;
+        bool has_command = queued_commands_.load(std::memory_order_acquire) > 0 && xQueueReceive(queue_, &command, 0) == pdTRUE;
+        if (has_command)
+        {
+            queued_commands_.fetch_sub(1, std::memory_order_relaxed);
+        }
 
-                if (position_updated || new_config.position_width_radians != config.position_width_radians)
-                {
-                    LOGD("adjusting detent center");
-                    float new_sub_position = position_updated ? new_config.sub_position_unit : latest_sub_position_unit;
+        if (!c.motor.calibrated && (has_config || has_haptic || has_command))
+        {
+            LOGI("Ignoring command, motor not calibrated!");
+            if (motor.enabled)
+                motor.disable();
+
+            continue;
+        }
+
+        if (has_config)
+        {
+            // Check new config for validity
+            const char *error = DetentEngine::validate(new_config);
+            if (error != nullptr)
+            {
+                LOGD("Ignoring invalid config: %s", error);
+            }
+            else
+            {
 #if SK_INVERT_ROTATION
-                    float shaft_angle = -motor.shaft_angle;
+                float shaft_angle = -motor.shaft_angle;
 #else
-                    float shaft_angle = motor.shaft_angle;
+                float shaft_angle = motor.shaft_angle;
 #endif
-                    current_detent_center = shaft_angle + new_sub_position * new_config.position_width_radians;
-                }
-                config = new_config;
+                engine.setConfig(new_config, shaft_angle, detentIndexFor(new_config));
+                setAppliedConfig(engine.config());
                 LOGI("Got new config");
-
-                // Update derivative factor of torque controller based on detent width.
-                // If the D factor is large on coarse detents, the motor ends up making noise because the P&D factors amplify the noise from the sensor.
-                // This is a piecewise linear function so that fine detents (small width) get a higher D factor and coarse detents get a small D factor.
-                // Fine detents need a nonzero D factor to artificially create "clicks" each time a new value is reached (the P factor is small
-                // for fine detents due to the smaller angular errors, and the existing P factor doesn't work well for very small angle changes (easy to
-                // get runaway due to sensor noise & lag)).
-                // TODO: consider eliminating this D factor entirely and just "play" a hardcoded haptic "click" (e.g. a quick burst of torque in each
-                // direction) whenever the position changes when the detent width is too small for the P factor to work well.
-                const float derivative_lower_strength = config.detent_strength_unit * 0.08;
-                const float derivative_upper_strength = config.detent_strength_unit * 0.02;
-                const float derivative_position_width_lower = radians(3);
-                const float derivative_position_width_upper = radians(8);
-                const float raw = derivative_lower_strength + (derivative_upper_strength - derivative_lower_strength) / (derivative_position_width_upper - derivative_position_width_lower) * (config.position_width_radians - derivative_position_width_lower);
-                // When there are intermittent detents (set via detent_positions), disable derivative factor as this adds extra "clicks" when nearing
-                // a detent.
-                motor.PID_velocity.D = config.detent_positions_count > 0 ? 0 : CLAMP(raw, min(derivative_lower_strength, derivative_upper_strength), max(derivative_lower_strength, derivative_upper_strength));
-                break;
             }
-            case CommandType::HAPTIC:
+        }
+
+        if (has_command)
+        {
+            switch (command.command_type)
+            {
+            case CommandType::HAPTIC_WAVEFORM:
             {
-                int foc_ticks = 3;
-                // Play a hardcoded haptic "click"
-                float strength = command.data.haptic.press ? 5 : 1.5;
-                if (command.data.haptic.long_press)
+                HapticWaveformUpload &upload = command.data.haptic_waveform;
+                haptic_.setUserWaveform(upload.slot, upload.samples, upload.length);
+                // Played from here rather than through haptic_ring_, which could overtake the upload
+                if (upload.strength != 0)
                 {
-                    strength = 20;
-                    foc_ticks = 6;
+                    haptic = {
+                        .waveform = static_cast<HapticWaveform>(static_cast<uint8_t>(HapticWaveform::USER_0) + upload.slot),
+                        .strength = upload.strength,
+                        .sample_ticks = upload.sample_ticks,
+                    };
+                    has_haptic = true;
                 }
-                motor.move(strength);
-                for (uint8_t i = 0; i < foc_ticks; i++)
+                break;
+            }
+            case CommandType::DETENT_POSITIONS:
+            {
+                PB_DetentPositions &chunk = command.data.detent_positions;
+                if (!detent_index_.applyChunk(chunk))
                 {
-                    motor.loopFOC();
-                    delay(1);
+                    LOGW("Ignoring detent positions chunk for '%s' at offset %u (total %u)", chunk.config_id, chunk.offset, chunk.total);
                 }
-                motor.move(-strength);
-                for (uint8_t i = 0; i < foc_ticks; i++)
+                else if (detent_index_.isComplete())
                 {
-                    motor.loopFOC();
-                    delay(1);
+                    LOGD("Received %u detent positions for '%s'", detent_index_.size(), chunk.config_id);
                 }
-                motor.move(0);
-                motor.loopFOC();
+                // The profile may point at the index, so recompile even if the upload is still incomplete
+                engine.recompile(detentIndexFor(engine.config()));
                 break;
             }
             }
         }
 
-        // If we are not moving and we're close to the center (but not exactly there), slowly adjust the centerpoint to match the current position
-        idle_check_velocity_ewma = motor.shaft_velocity * IDLE_VELOCITY_EWMA_ALPHA + idle_check_velocity_ewma * (1 - IDLE_VELOCITY_EWMA_ALPHA);
-        if (fabsf(idle_check_velocity_ewma) > IDLE_VELOCITY_RAD_PER_SEC)
+        if (has_haptic)
         {
-            last_idle_start = 0;
-        }
-        else
-        {
-            if (last_idle_start == 0)
+#if SK_MOTOR_IDLE
+            if (idle_)
             {
-                last_idle_start = millis();
+                setIdle(false);
+                last_wake = millis();
             }
-        }
-        if (last_idle_start > 0 && millis() - last_idle_start > IDLE_CORRECTION_DELAY_MILLIS && fabsf(motor.shaft_angle - current_detent_center) < IDLE_CORRECTION_MAX_ANGLE_RAD)
-        {
-            current_detent_center = motor.shaft_angle * IDLE_CORRECTION_RATE_ALPHA + current_detent_center * (1 - IDLE_CORRECTION_RATE_ALPHA);
+#endif
+            haptic_.play(haptic.waveform, haptic.strength, haptic.sample_ticks);
         }
 
-        // Check where we are relative to the current nearest detent; update our position if we've moved far enough to snap to another detent
-        float angle_to_detent_center = motor.shaft_angle - current_detent_center;
+#if SK_MOTOR_TIMING
+        timing_.record(MotorTimingStage::COMMANDS, ESP.getCycleCount() - stage_start_cycles);
+        stage_start_cycles = ESP.getCycleCount();
+#endif
+
+        // Detent state and torque (snapping, bounds, idle re-centering, damping) all live in the engine, in the knob's frame
 #if SK_INVERT_ROTATION
-        angle_to_detent_center = -motor.shaft_angle - current_detent_center;
+        DetentOutput detent = engine.update(-motor.shaft_angle, -motor.shaft_velocity, micros());
+        float torque = -detent.torque;
+#else
+        DetentOutput detent = engine.update(motor.shaft_angle, motor.shaft_velocity, micros());
+        float torque = detent.torque;
 #endif
 
-        float snap_point_radians = config.position_width_radians * config.snap_point;
-        float bias_radians = config.position_width_radians * config.snap_point_bias;
-        float snap_point_radians_decrease = snap_point_radians + (current_position <= 0 ? bias_radians : -bias_radians);
-        float snap_point_radians_increase = -snap_point_radians + (current_position >= 0 ? -bias_radians : bias_radians);
+#if SK_MOTOR_THERMAL_LIMIT
+        // Sustained loads (e.g. leaning on an endstop) drain the thermal budget, which derates the detent torque
+        torque *= thermal.scale();
+#endif
 
-        int32_t num_positions = config.max_position - config.min_position + 1;
-        if (angle_to_detent_center > snap_point_radians_decrease && (num_positions <= 0 || current_position > config.min_position))
-        {
-            current_detent_center += config.position_width_radians;
-            angle_to_detent_center -= config.position_width_radians;
-            current_position--;
-        }
-        else if (angle_to_detent_center < snap_point_radians_increase && (num_positions <= 0 || current_position < config.max_position))
-        {
-            current_detent_center -= config.position_width_radians;
-            angle_to_detent_center += config.position_width_radians;
-            current_position++;
-        }
+        // Haptic effects are mixed on top of the detent torque one sample per tick, so playing them never stalls the loop
+        torque += haptic_.tick();
+        motor.move(torque);
 
-        latest_sub_position_unit = -angle_to_detent_center / config.position_width_radians;
+#if SK_MOTOR_THERMAL_LIMIT
+        updateThermal(thermal);
+#endif
 
-        float dead_zone_adjustment = CLAMP(
-            angle_to_detent_center,
-            fmaxf(-config.position_width_radians * DEAD_ZONE_DETENT_PERCENT, -DEAD_ZONE_RAD),
-            fminf(config.position_width_radians * DEAD_ZONE_DETENT_PERCENT, DEAD_ZONE_RAD));
+#if SK_RECORDER_MOTOR
+        motion_angle_.store(motor.shaft_angle, std::memory_order_relaxed);
+        motion_torque_.store(torque, std::memory_order_relaxed);
+#endif
 
-        bool out_of_bounds = num_positions > 0 && ((angle_to_detent_center > 0 && current_position == config.min_position) || (angle_to_detent_center < 0 && current_position == config.max_position));
-        motor.PID_velocity.limit = 10; // out_of_bounds ? 10 : 3;
-        motor.PID_velocity.P = out_of_bounds ? config.endstop_strength_unit * 4 : config.detent_strength_unit * 4;
+#if SK_MOTOR_TIMING
+        timing_.record(MotorTimingStage::DETENT, ESP.getCycleCount() - stage_start_cycles);
+#endif
 
-        // Apply motor torque based on our angle to the nearest detent (detent strength, etc is handled by the PID_velocity parameters)
-        if (fabsf(motor.shaft_velocity) > 60)
-        {
-            // Don't apply torque if velocity is too high (helps avoid positive feedback loop/runaway)
-            motor.move(0);
-        }
-        else
+        // Publish to other registered tasks when something changed: immediately on a detent crossing or new config, rate
+        // limited while the sub-position moves, and at a slow heartbeat otherwise
+        uint32_t now_millis = millis();
+        bool position_changed = !has_published || detent.position != last_published.current_position || config_generation_ != last_published.config_generation;
+        bool sub_position_changed = fabsf(detent.sub_position_unit - last_published.sub_position_unit) > PUBLISH_SUB_POSITION_THRESHOLD && now_millis - last_publish > PUBLISH_SUB_POSITION_INTERVAL_MILLIS;
+        if (position_changed || sub_position_changed || now_millis - last_publish > PUBLISH_HEARTBEAT_INTERVAL_MILLIS)
         {
-            float input = -angle_to_detent_center + dead_zone_adjustment;
-            if (!out_of_bounds && config.detent_positions_count > 0)
-            {
-                bool in_detent = false;
-                for (uint8_t i = 0; i < config.detent_positions_count; i++)
-                {
-                    if (config.detent_positions[i] == current_position)
-                    {
-                        in_detent = true;
-                        break;
-                    }
-                }
-                if (!in_detent)
-                {
-                    input = 0;
-                }
-            }
-            float torque = motor.PID_velocity(input);
-#if SK_INVERT_ROTATION
-            torque = -torque;
+#if SK_MOTOR_TIMING
+            stage_start_cycles = ESP.getCycleCount();
+#endif
+            last_published = {
+                .current_position = detent.position,
+                .sub_position_unit = detent.sub_position_unit,
+                .config_generation = config_generation_,
+            };
+            publish(last_published);
+            has_published = true;
+            last_publish = now_millis;
+#if SK_MOTOR_TIMING
+            timing_.record(MotorTimingStage::PUBLISH, ESP.getCycleCount() - stage_start_cycles);
 #endif
-            motor.move(torque);
         }
+    }
+}
 
-        // Publish current status to other registered tasks periodically
-        if (millis() - last_publish > 5)
-        {
-            publish({
-                .current_position = current_position,
-                .sub_position_unit = latest_sub_position_unit,
-                .has_config = true,
-                .config = config,
-            });
-            last_publish = millis();
-        }
+#if SK_MOTOR_LOOP_HZ
+void MotorTask::startLoopTimer()
+{
+    loop_timer_task_ = xTaskGetCurrentTaskHandle();
 
-        delay(1);
+    loop_timer_ = timerBegin(LOOP_TIMER_INDEX, LOOP_TIMER_DIVIDER, true);
+    assert(loop_timer_ != NULL);
+    timerAttachInterrupt(loop_timer_, &onLoopTimer, true);
+    timerAlarmWrite(loop_timer_, LOOP_PERIOD_US, true);
+    timerAlarmEnable(loop_timer_);
+
+    LOGI("Motor loop running at %d Hz (detent stage at %d Hz)", SK_MOTOR_LOOP_HZ, SK_MOTOR_LOOP_HZ / SK_MOTOR_DETENT_DIVIDER);
+}
+
+void MotorTask::checkLoopTiming(const LoopTimingStats &stats)
+{
+    if (stats.samples == 0)
+    {
+        return;
+    }
+
+    uint32_t jitter_us = max(max(stats.max_period_us, LOOP_PERIOD_US) - LOOP_PERIOD_US, LOOP_PERIOD_US - min(stats.min_period_us, LOOP_PERIOD_US));
+    if (jitter_us > SK_MOTOR_JITTER_BUDGET_US || stats.missed_ticks > 0)
+    {
+        LOGW("Motor loop over jitter budget: period %u-%uus (nominal %uus, budget %uus), %u missed ticks",
+             stats.min_period_us,
+             stats.max_period_us,
+             LOOP_PERIOD_US,
+             SK_MOTOR_JITTER_BUDGET_US,
+             stats.missed_ticks);
+    }
+    else
+    {
+        LOGV(PB_LogLevel_DEBUG, "Motor loop period %u-%uus (nominal %uus)", stats.min_period_us, stats.max_period_us, LOOP_PERIOD_US);
     }
 }
+#endif
 
 void MotorTask::setConfig(const PB_SmartKnobConfig config)
+{
+    // Only the latest config matters, so this just replaces whatever the motor loop hasn't picked up yet
+    config_mailbox_.put(config);
+}
+
+bool MotorTask::setDetentPositions(const PB_DetentPositions &detent_positions)
 {
     Command command = {
-        .command_type = CommandType::CONFIG,
+        .command_type = CommandType::DETENT_POSITIONS,
         .data = {
-            .config = config,
+            .detent_positions = detent_positions,
         }};
-    xQueueSend(queue_, &command, portMAX_DELAY);
+    return sendCommand(command);
+}
+
+const DetentIndex *MotorTask::detentIndexFor(const PB_SmartKnobConfig &config) const
+{
+    return detent_index_.isComplete() && detent_index_.matches(config.id) ? &detent_index_ : nullptr;
 }
 
+void MotorTask::setEngaged(bool engaged)
+{
+    engaged_.store(engaged, std::memory_order_relaxed);
+}
+
+#if SK_MOTOR_IDLE
+void MotorTask::setIdle(bool idle)
+{
+    idle_ = idle;
+    motor.voltage_limit = idle ? FOC_VOLTAGE_LIMIT * IDLE_MODE_VOLTAGE_SCALE : FOC_VOLTAGE_LIMIT;
+    LOGD("Motor %s", idle ? "idle" : "active");
+}
+#endif
+
 void MotorTask::playHaptic(bool press, bool long_press)
 {
+    // Play a hardcoded haptic "click"
+    float strength = press ? 5 : 1.5;
+    uint8_t sample_ticks = 1;
+    if (long_press)
+    {
+        strength = 20;
+        sample_ticks = 2;
+    }
+    playHapticWaveform(HapticWaveform::CLICK, strength, sample_ticks);
+}
+
+void MotorTask::playHapticWaveform(HapticWaveform waveform, float strength, uint8_t sample_ticks)
+{
+    HapticData haptic = {
+        .waveform = waveform,
+        .strength = strength,
+        .sample_ticks = sample_ticks,
+    };
+    if (!haptic_ring_.push(haptic))
+    {
+        LOGW("Dropping haptic, too many pending");
+    }
+}
+
+bool MotorTask::uploadHapticWaveform(uint8_t slot, const int8_t *samples, uint8_t length, float strength, uint8_t sample_ticks)
+{
+    if (slot >= HAPTIC_USER_WAVEFORM_COUNT || length > HAPTIC_MAX_SAMPLES)
+    {
+        return false;
+    }
+
     Command command = {
-        .command_type = CommandType::HAPTIC,
+        .command_type = CommandType::HAPTIC_WAVEFORM,
         .data = {
-            .haptic = {
-                .press = press,
-                .long_press = long_press,
+            .haptic_waveform = {
+                .slot = slot,
+                .length = length,
+                .strength = strength,
+                .sample_ticks = sample_ticks,
             },
         }};
-    xQueueSend(queue_, &command, portMAX_DELAY);
+    memcpy(command.data.haptic_waveform.samples, samples, length);
+    return sendCommand(command);
+}
+
+bool MotorTask::playHapticEffect(const PB_HapticEffect &effect)
+{
+    if (effect.waveform >= static_cast<uint8_t>(HapticWaveform::USER_0) + HAPTIC_USER_WAVEFORM_COUNT || effect.sample_ticks > UINT8_MAX)
+    {
+        return false;
+    }
+
+    if (effect.samples.size > 0)
+    {
+        if (effect.waveform < static_cast<uint8_t>(HapticWaveform::USER_0))
+        {
+            return false;
+        }
+        return uploadHapticWaveform(effect.waveform - static_cast<uint8_t>(HapticWaveform::USER_0), (const int8_t *)effect.samples.bytes, effect.samples.size, effect.strength, effect.sample_ticks);
+    }
+
+    if (effect.strength != 0)
+    {
+        playHapticWaveform(static_cast<HapticWaveform>(effect.waveform), effect.strength, effect.sample_ticks);
+    }
+    return true;
 }
 
 void MotorTask::runCalibration()
 {
-    Command command = {
-        .command_type = CommandType::CALIBRATE,
-        .data = {
-            .unused = 0,
-        }};
-    xQueueSend(queue_, &command, portMAX_DELAY);
+    calibration_requested_.store(true, std::memory_order_release);
 }
 
+void MotorTask::runAutotune()
+{
+    autotune_requested_.store(true, std::memory_order_release);
+}
+
+bool MotorTask::sendCommand(const Command &command)
+{
+    // Don't wait for room: the motor loop doesn't drain the queue while calibrating or autotuning
+    if (xQueueSend(queue_, &command, 0) != pdTRUE)
+    {
+        LOGW("Dropping motor command, too many pending");
+        return false;
+    }
+    queued_commands_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool MotorTask::readTiming(PB_MotorTiming &timing)
+{
+#if SK_MOTOR_TIMING
+    timing_.readAndReset(timing);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MotorTask::setDieTemperature(float celsius)
+{
+#if SK_MOTOR_THERMAL_LIMIT
+    die_celsius_.store(celsius, std::memory_order_relaxed);
+#endif
+}
+
+bool MotorTask::readThermal(PB_MotorThermal &thermal)
+{
+#if SK_MOTOR_THERMAL_LIMIT
+    uint32_t generation = 0;
+    return thermal_mailbox_.take(thermal, generation);
+#else
+    return false;
+#endif
+}
+
+bool MotorTask::readMotion(float &angle, float &torque)
+{
+#if SK_RECORDER_MOTOR
+    angle = motion_angle_.load(std::memory_order_relaxed);
+    torque = motion_torque_.load(std::memory_order_relaxed);
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if SK_MOTOR_THERMAL_LIMIT
+void MotorTask::updateThermal(ThermalLimiter &thermal)
+{
+    uint32_t now_us = micros();
+    uint32_t dt_us = last_thermal_us_ == 0 ? 0 : now_us - last_thermal_us_;
+    last_thermal_us_ = now_us;
+
+    // voltage.q is what was actually commanded after SimpleFOC's voltage limit, so haptic effects count towards the
+    // budget too
+    float scale = thermal.update(motor.voltage.q, dt_us * 1e-6f);
+    if (scale < 1)
+    {
+        derated_us_ += dt_us;
+    }
+
+    if (!derate_logged_ && scale < THERMAL_WARN_SCALE)
+    {
+        LOGW("Motor thermal budget low (%.2f), derating torque to %.0f%%", thermal.budget(), scale * 100);
+        derate_logged_ = true;
+    }
+    else if (derate_logged_ && scale >= 1)
+    {
+        LOGI("Motor thermal budget recovered");
+        derate_logged_ = false;
+    }
+
+    uint32_t now_millis = millis();
+    if (now_millis - last_thermal_report_ > THERMAL_REPORT_INTERVAL_MILLIS)
+    {
+        thermal.setDieCelsius(die_celsius_.load(std::memory_order_relaxed));
+        thermal_mailbox_.put({
+            .budget = thermal.budget(),
+            .torque_scale = scale,
+            .die_celsius = thermal.dieCelsius(),
+            .derated_millis = (uint32_t)(derated_us_ / 1000),
+        });
+        last_thermal_report_ = now_millis;
+    }
+}
+#endif
+
 void MotorTask::addListener(QueueHandle_t queue)
 {
     listeners_.push_back(queue);
 }
 
-void MotorTask::publish(const PB_SmartKnobState &state)
+uint32_t MotorTask::getConfig(PB_SmartKnobConfig &config)
+{
+    SemaphoreGuard lock(config_mutex_);
+    config = applied_config_;
+    return config_generation_;
+}
+
+void MotorTask::publish(const MotorState &state)
 {
     for (auto listener : listeners_)
     {
@@ -408,15 +784,28 @@ void MotorTask::publish(const PB_SmartKnobState &state)
     }
 }
 
+void MotorTask::setAppliedConfig(const PB_SmartKnobConfig &config)
+{
+    SemaphoreGuard lock(config_mutex_);
+    applied_config_ = config;
+    config_generation_++;
+}
+
 void MotorTask::calibrate()
 {
     // SimpleFOC is supposed to be able to determine this automatically (if you omit params to initFOC), but
     // it seems to have a bug (or I've misconfigured it) that gets both the offset and direction very wrong!
-    // So this value is based on experimentation.
+    // So these values are measured here instead.
     // TODO: dig into SimpleFOC calibration and find/fix the issue
 
     LOGI("Starting calibration, please DO NOT TOUCH MOTOR until complete!");
-    delay(1000);
+    calib_state_ = {};
+    reportCalibration(MotorCalibStep::STARTING, 0);
+
+#if SENSOR_MT6701 || SENSOR_TLV
+    // Calibration has to see the raw sensor angle
+    encoder.setAngleCorrection(nullptr, 0);
+#endif
 
     motor.controller = MotionControlType::angle_openloop;
     motor.pole_pairs = 1;
@@ -424,190 +813,207 @@ void MotorTask::calibrate()
     motor.sensor_direction = Direction::CW;
     motor.initFOC();
 
+    std::vector<CalibrationSample> samples;
+    samples.reserve(CALIBRATION_MAX_SAMPLES);
+
     float a = 0;
+    uint16_t tick = 0;
+    float sweep_start = 0;
+    uint32_t last_report = millis();
 
     motor.voltage_limit = FOC_VOLTAGE_LIMIT;
-    motor.move(a);
-
-    // #### Determine direction motor rotates relative to angle sensor
-    for (uint8_t i = 0; i < 200; i++)
+    for (uint16_t i = 0; i < CALIBRATION_SETTLE_MILLIS; i++)
     {
         encoder.update();
         motor.move(a);
         delay(1);
     }
-    float start_sensor = encoder.getAngle();
 
-    for (; a < 3 * _2PI; a += 0.01)
+    // Advance the field and keep every Nth sample, skipping the start of each sweep while the rotor catches up
+    auto sweep_step = [&](float step)
     {
-        encoder.update();
+        a += step;
         motor.move(a);
         delay(1);
-    }
-
-    for (uint8_t i = 0; i < 200; i++)
-    {
         encoder.update();
-        delay(1);
-    }
-    float end_sensor = encoder.getAngle();
-
-    motor.voltage_limit = 0;
-    motor.move(a);
-
-    float movement_angle = fabsf(end_sensor - start_sensor);
-    if (movement_angle < radians(30) || movement_angle > radians(180))
+        if (++tick % CALIBRATION_SAMPLE_DIVIDER == 0 && fabsf(a - sweep_start) > CALIBRATION_SKIP_ELECTRICAL_RAD && samples.size() < CALIBRATION_MAX_SAMPLES)
+        {
+            samples.push_back({
+                .electrical = a,
+                .mechanical = encoder.getAngle(),
+            });
+        }
+    };
+    auto report_progress = [&](MotorCalibStep step, float progress)
     {
-        snprintf(buf_, sizeof(buf_), "ERROR! Unexpected sensor change: start=%.2f end=%.2f", start_sensor, end_sensor);
-        LOGE(buf_);
-        return;
-    }
+        if (millis() - last_report > CALIBRATION_REPORT_INTERVAL_MILLIS)
+        {
+            reportCalibration(step, progress);
+            last_report = millis();
+        }
+    };
 
-    LOGD("Sensor measures positive for positive motor rotation:");
-    if (end_sensor > start_sensor)
+    // #### Sweep
+    // Turn the field continuously, forward until the rotor has made a bit more than one mechanical revolution and then
+    // back over the same electrical range. The rotor lags the field by about the same amount in each direction, so
+    // fitting both sweeps together cancels the lag out.
+    const float start_sensor = encoder.getAngle();
+    sweep_start = a;
+    while (fabsf(encoder.getAngle() - start_sensor) < CALIBRATION_SWEEP_MECHANICAL_RAD)
     {
-        LOGD("YES, Direction=CW");
-        motor.zero_electric_angle = 0;
-        motor.sensor_direction = Direction::CW;
-        motor.initFOC();
-    }
-    else
-    {
-        LOGD("NO, Direction=CCW");
-        motor.zero_electric_angle = 0;
-        motor.sensor_direction = Direction::CCW;
-        motor.initFOC();
+        if (a > CALIBRATION_MAX_ELECTRICAL_RAD)
+        {
+            snprintf(buf_, sizeof(buf_), "ERROR! Motor barely moved: start=%.2f end=%.2f", start_sensor, encoder.getAngle());
+            failCalibration(buf_);
+            return;
+        }
+        sweep_step(CALIBRATION_SWEEP_STEP_RAD);
+        report_progress(MotorCalibStep::SWEEP_FORWARD, fabsf(encoder.getAngle() - start_sensor) / CALIBRATION_SWEEP_MECHANICAL_RAD);
     }
-    snprintf(buf_, sizeof(buf_), "  (start was %.1f, end was %.1f)", start_sensor, end_sensor);
-    LOGD(buf_);
 
-    // #### Determine pole-pairs
-    // Rotate 20 electrical revolutions and measure mechanical angle traveled, to calculate pole-pairs
-    uint8_t electrical_revolutions = 20;
-    snprintf(buf_, sizeof(buf_), "Going to measure %d electrical revolutions...", electrical_revolutions);
-    LOGI(buf_);
-    motor.voltage_limit = FOC_VOLTAGE_LIMIT;
-    motor.move(a);
-    LOGI("Going to electrical zero...");
-    float destination = a + _2PI;
-    for (; a < destination; a += 0.03)
+    for (uint16_t i = 0; i < CALIBRATION_SETTLE_MILLIS; i++)
     {
         encoder.update();
         motor.move(a);
         delay(1);
     }
-    LOGI("pause..."); // Let momentum settle...
-    for (uint16_t i = 0; i < 1000; i++)
+
+    const float sweep_end = a;
+    sweep_start = a;
+    while (a > 0)
     {
-        encoder.update();
-        delay(1);
+        sweep_step(-CALIBRATION_SWEEP_STEP_RAD);
+        report_progress(MotorCalibStep::SWEEP_BACKWARD, 1 - a / sweep_end);
     }
-    LOGI("Measuring...");
+    motor.voltage_limit = 0;
+    motor.move(a);
 
-    start_sensor = motor.sensor_direction * encoder.getAngle();
-    destination = a + electrical_revolutions * _2PI;
-    for (; a < destination; a += 0.03)
+    reportCalibration(MotorCalibStep::FITTING, 0);
+    if (samples.size() < CALIBRATION_MIN_SAMPLES)
     {
-        encoder.update();
-        motor.move(a);
-        delay(1);
+        snprintf(buf_, sizeof(buf_), "ERROR! Only collected %u samples", samples.size());
+        failCalibration(buf_);
+        return;
     }
-    for (uint16_t i = 0; i < 1000; i++)
+    snprintf(buf_, sizeof(buf_), "Fitting %u samples over %.1f electrical revolutions", samples.size(), sweep_end / _2PI);
+    LOGD(buf_);
+
+    // #### Determine direction and pole-pairs
+    // Least-squares slope of sensor angle vs field angle, i.e. +-1/pole_pairs
+    double mean_electrical = 0;
+    double mean_mechanical = 0;
+    for (const CalibrationSample &sample : samples)
     {
-        encoder.update();
-        motor.move(a);
-        delay(1);
+        mean_electrical += sample.electrical;
+        mean_mechanical += sample.mechanical;
     }
-    end_sensor = motor.sensor_direction * encoder.getAngle();
-    motor.voltage_limit = 0;
-    motor.move(a);
-
-    if (fabsf(motor.shaft_angle - motor.target) > 1 * PI / 180)
+    mean_electrical /= samples.size();
+    mean_mechanical /= samples.size();
+    double covariance = 0;
+    double variance = 0;
+    for (const CalibrationSample &sample : samples)
     {
-        LOGE("ERROR: motor did not reach target!");
-        while (1)
-        {
-        }
+        double electrical = sample.electrical - mean_electrical;
+        covariance += electrical * (sample.mechanical - mean_mechanical);
+        variance += electrical * electrical;
     }
+    float slope = covariance / variance;
+
+    LOGD("Sensor measures positive for positive motor rotation:");
+    const Direction direction = slope > 0 ? Direction::CW : Direction::CCW;
+    LOGD(direction == Direction::CW ? "YES, Direction=CW" : "NO, Direction=CCW");
 
-    float electrical_per_mechanical = electrical_revolutions * _2PI / (end_sensor - start_sensor);
+    float electrical_per_mechanical = 1 / fabsf(slope);
     snprintf(buf_, sizeof(buf_), "Electrical angle / mechanical angle (i.e. pole pairs) = %.2f", electrical_per_mechanical);
     LOGD(buf_);
-
     if (electrical_per_mechanical < 3 || electrical_per_mechanical > 12)
     {
         snprintf(buf_, sizeof(buf_), "ERROR! Unexpected calculated pole pairs: %.2f", electrical_per_mechanical);
-        LOGE(buf_);
+        failCalibration(buf_);
         return;
     }
-
     int measured_pole_pairs = (int)round(electrical_per_mechanical);
     snprintf(buf_, sizeof(buf_), "Pole pairs set to %d", measured_pole_pairs);
     LOGD(buf_);
 
-    delay(1000);
-
     // #### Determine mechanical offset to electrical zero
-    // Measure mechanical angle at every electrical zero for several revolutions
-    motor.voltage_limit = FOC_VOLTAGE_LIMIT;
-    motor.move(a);
+    // Circular mean of the difference between the electrical angle implied by the sensor and the field angle
     float offset_x = 0;
     float offset_y = 0;
-    float destination1 = (floor(a / _2PI) + measured_pole_pairs / 2.) * _2PI;
-    float destination2 = (floor(a / _2PI)) * _2PI;
-    for (; a < destination1; a += 0.4)
+    for (const CalibrationSample &sample : samples)
     {
-        motor.move(a);
-        delay(100);
-        for (uint8_t i = 0; i < 100; i++)
-        {
-            encoder.update();
-            delay(1);
-        }
-        float real_electrical_angle = _normalizeAngle(a);
-        float measured_electrical_angle = _normalizeAngle((float)(motor.sensor_direction * measured_pole_pairs) * encoder.getMechanicalAngle() - 0);
-
-        float offset_angle = measured_electrical_angle - real_electrical_angle;
+        float offset_angle = (float)(direction * measured_pole_pairs) * sample.mechanical - sample.electrical;
         offset_x += cosf(offset_angle);
         offset_y += sinf(offset_angle);
+    }
+    float avg_offset_angle = atan2f(offset_y, offset_x);
 
-        snprintf(buf_, sizeof(buf_), "%.2f, %.2f, %.2f", degrees(real_electrical_angle), degrees(measured_electrical_angle), degrees(_normalizeAngle(offset_angle)));
-        LOGD(buf_);
+    // #### Measure sensor angle error
+    // With the pole pairs known, the sensor should read a fixed offset plus field angle / pole pairs; the rest is sensor
+    // error. Errors are binned by raw sensor angle (split linearly between the two nearest entries) to build the
+    // correction table.
+    const float expected_slope = (float)direction / measured_pole_pairs;
+    double intercept = 0;
+    for (const CalibrationSample &sample : samples)
+    {
+        intercept += sample.mechanical - expected_slope * sample.electrical;
     }
-    for (; a > destination2; a -= 0.4)
+    intercept /= samples.size();
+
+    float correction_sum[ANGLE_CORRECTION_SIZE] = {};
+    float correction_weight[ANGLE_CORRECTION_SIZE] = {};
+    for (const CalibrationSample &sample : samples)
     {
-        motor.move(a);
-        delay(100);
-        for (uint8_t i = 0; i < 100; i++)
+        float error = sample.mechanical - (expected_slope * sample.electrical + intercept);
+
+        float bin = _normalizeAngle(sample.mechanical) * ANGLE_CORRECTION_SIZE / _2PI;
+        uint8_t lower = (uint8_t)bin % ANGLE_CORRECTION_SIZE;
+        uint8_t upper = (lower + 1) % ANGLE_CORRECTION_SIZE;
+        float frac = bin - floorf(bin);
+        correction_sum[lower] += error * (1 - frac);
+        correction_weight[lower] += 1 - frac;
+        correction_sum[upper] += error * frac;
+        correction_weight[upper] += frac;
+    }
+
+    float angle_correction[ANGLE_CORRECTION_SIZE];
+    pb_size_t angle_correction_count = ANGLE_CORRECTION_SIZE;
+    float mean_error = 0;
+    for (uint8_t i = 0; i < ANGLE_CORRECTION_SIZE; i++)
+    {
+        if (correction_weight[i] <= 0)
         {
-            encoder.update();
-            delay(1);
+            LOGE("ERROR! Sensor angle sweep missed part of the revolution, not applying angle correction");
+            angle_correction_count = 0;
+            break;
         }
-        float real_electrical_angle = _normalizeAngle(a);
-        float measured_electrical_angle = _normalizeAngle((float)(motor.sensor_direction * measured_pole_pairs) * encoder.getMechanicalAngle() - 0);
-
-        float offset_angle = measured_electrical_angle - real_electrical_angle;
-        offset_x += cosf(offset_angle);
-        offset_y += sinf(offset_angle);
-
-        snprintf(buf_, sizeof(buf_), "%.2f, %.2f, %.2f", degrees(real_electrical_angle), degrees(measured_electrical_angle), degrees(_normalizeAngle(offset_angle)));
-        LOGD(buf_);
+        angle_correction[i] = correction_sum[i] / correction_weight[i];
+        mean_error += angle_correction[i] / ANGLE_CORRECTION_SIZE;
     }
-    motor.voltage_limit = 0;
-    motor.move(a);
-
-    float avg_offset_angle = atan2f(offset_y, offset_x);
+    // Constant offset is part of the electrical zero, only keep the variation
+    float max_error = 0;
+    for (uint8_t i = 0; i < angle_correction_count; i++)
+    {
+        angle_correction[i] -= mean_error;
+        max_error = max(max_error, fabsf(angle_correction[i]));
+    }
+    snprintf(buf_, sizeof(buf_), "Sensor angle error: max %.2f deg", degrees(max_error));
+    LOGD(buf_);
 
-    // #### Apply settings
-    motor.pole_pairs = measured_pole_pairs;
-    motor.zero_electric_angle = avg_offset_angle + _3PI_2;
-    motor.voltage_limit = FOC_VOLTAGE_LIMIT;
-    motor.controller = MotionControlType::torque;
+    // #### Save settings
+    PB_MotorCalibration calibration = {
+        .calibrated = true,
+        .zero_electrical_offset = avg_offset_angle + _3PI_2,
+        .direction_cw = direction == Direction::CW,
+        .pole_pairs = (uint32_t)measured_pole_pairs,
+        .angle_correction_count = angle_correction_count,
+    };
+    memcpy(calibration.angle_correction, angle_correction, angle_correction_count * sizeof(float));
 
     LOGI("RESULTS:");
-    snprintf(buf_, sizeof(buf_), "  ZERO_ELECTRICAL_OFFSET: %.2f", motor.zero_electric_angle);
+    snprintf(buf_, sizeof(buf_), "  ZERO_ELECTRICAL_OFFSET: %.2f", calibration.zero_electrical_offset);
     LOGI(buf_);
-    if (motor.sensor_direction == Direction::CW)
+    if (calibration.direction_cw)
     {
         LOGI("  FOC_DIRECTION: Direction::CW");
     }
@@ -615,22 +1021,154 @@ void MotorTask::calibrate()
     {
         LOGI("  FOC_DIRECTION: Direction::CCW");
     }
-    snprintf(buf_, sizeof(buf_), "  MOTOR_POLE_PAIRS: %d", motor.pole_pairs);
+    snprintf(buf_, sizeof(buf_), "  MOTOR_POLE_PAIRS: %d", calibration.pole_pairs);
     LOGI(buf_);
 
     LOGI("Saving to persistent configuration...");
-    PB_MotorCalibration calibration = {
+    if (configuration_.setMotorCalibrationAndSave(calibration))
+    {
+        LOGI("Success!");
+    }
+
+    calib_state_ = {
         .calibrated = true,
-        .zero_electrical_offset = motor.zero_electric_angle,
-        .direction_cw = motor.sensor_direction == Direction::CW,
-        .pole_pairs = (uint32_t)motor.pole_pairs,
+        .step = (uint32_t)MotorCalibStep::DONE,
+        .progress = 1,
+        .pole_pairs = calibration.pole_pairs,
+        .zero_electrical_offset = calibration.zero_electrical_offset,
+        .direction_cw = calibration.direction_cw,
+        .max_angle_error = max_error,
     };
-    if (configuration_.setMotorCalibrationAndSave(calibration))
+    calib_state_mailbox_.put(calib_state_);
+}
+
+void MotorTask::autotune()
+{
+    LOGI("Starting gain autotune, please DO NOT TOUCH MOTOR until complete!");
+
+    PB_GainSchedule schedule = {};
+    for (float width_degrees : AUTOTUNE_WIDTHS_DEGREES)
+    {
+        const float width = radians(width_degrees);
+        const float step = width / 2;
+
+        // Bisect for the smallest D that keeps the overshoot under the target. Alternate the step direction so the
+        // rotor stays around where it started.
+        float low = 0;
+        float high = AUTOTUNE_MAX_D;
+        bool responded = true;
+        for (uint8_t i = 0; i < AUTOTUNE_ITERATIONS && responded; i++)
+        {
+            float d = (low + high) / 2;
+            float overshoot;
+            responded = measureStepResponse(i % 2 == 0 ? step : -step, d, overshoot);
+            if (overshoot > AUTOTUNE_TARGET_OVERSHOOT)
+            {
+                low = d;
+            }
+            else
+            {
+                high = d;
+            }
+        }
+
+        DetentGains gains = resolveDetentGains(nullptr, width);
+        if (responded)
+        {
+            gains = {
+                .p = AUTOTUNE_P,
+                .d = high,
+                .torque_limit = AUTOTUNE_TORQUE_LIMIT,
+            };
+            snprintf(buf_, sizeof(buf_), "  %.0f deg: P=%.2f D=%.3f", width_degrees, gains.p, gains.d);
+        }
+        else
+        {
+            snprintf(buf_, sizeof(buf_), "  %.0f deg: no clean step response, keeping default D=%.3f", width_degrees, gains.d);
+        }
+        LOGI(buf_);
+
+        schedule.entries[schedule.entries_count++] = {
+            .position_width_radians = width,
+            .p = gains.p,
+            .d = gains.d,
+            .torque_limit = gains.torque_limit,
+        };
+    }
+    motor.move(0);
+
+    if (!isValidGainSchedule(schedule))
+    {
+        LOGE("ERROR! Autotune produced an invalid gain schedule, not saving");
+        return;
+    }
+    LOGI("Saving to persistent configuration...");
+    if (configuration_.setGainScheduleAndSave(schedule))
     {
         LOGI("Success!");
     }
 }
 
+bool MotorTask::measureStepResponse(float step, float d, float &overshoot)
+{
+    float target = motor.shaft_angle;
+    auto run_pd = [&](uint16_t duration_millis, float &max_past_target)
+    {
+        for (uint16_t i = 0; i < duration_millis; i++)
+        {
+            motor.loopFOC();
+            float torque = AUTOTUNE_STRENGTH * (AUTOTUNE_P * (target - motor.shaft_angle) - d * motor.shaft_velocity);
+            motor.move(CLAMP(torque, -AUTOTUNE_TORQUE_LIMIT, AUTOTUNE_TORQUE_LIMIT));
+            max_past_target = max(max_past_target, (motor.shaft_angle - target) * (step > 0 ? 1 : -1));
+            delay(1);
+        }
+    };
+
+    // Settle on the current angle, then step the target and record how far past it the rotor swings
+    float unused = 0;
+    run_pd(AUTOTUNE_SETTLE_MILLIS, unused);
+    const float start = motor.shaft_angle;
+    target = start + step;
+    float max_past_target = -fabsf(step);
+    run_pd(AUTOTUNE_RESPONSE_MILLIS, max_past_target);
+
+    overshoot = max(max_past_target, 0.0f) / fabsf(step);
+    return fabsf(motor.shaft_angle - start) > AUTOTUNE_MIN_RESPONSE * fabsf(step);
+}
+
+void MotorTask::failCalibration(const char *reason)
+{
+    LOGE(reason);
+    motor.voltage_limit = 0;
+    motor.move(0);
+    reportCalibration(MotorCalibStep::FAILED, 0);
+}
+
+void MotorTask::reportCalibration(MotorCalibStep step, float progress)
+{
+    calib_state_.step = (uint32_t)step;
+    calib_state_.progress = CLAMP(progress, 0.0f, 1.0f);
+    calib_state_mailbox_.put(calib_state_);
+}
+
+bool MotorTask::takeCalibState(PB_MotorCalibState &state, uint32_t &generation)
+{
+    return calib_state_mailbox_.take(state, generation);
+}
+
+void MotorTask::applyCalibration(const PB_MotorCalibration &calibration)
+{
+    motor.controller = MotionControlType::torque;
+    motor.voltage_limit = FOC_VOLTAGE_LIMIT;
+    motor.pole_pairs = calibration.pole_pairs;
+    motor.sensor_direction = calibration.direction_cw ? Direction::CW : Direction::CCW;
+#if SENSOR_MT6701 || SENSOR_TLV
+    encoder.setAngleCorrection(calibration.angle_correction, calibration.angle_correction_count);
+#endif
+    motor.zero_electric_angle = calibration.zero_electrical_offset;
+    motor.initFOC();
+}
+
 void MotorTask::checkSensorError()
 {
 #if SENSOR_TLV
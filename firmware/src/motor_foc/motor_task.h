@@ -2,24 +2,71 @@
 
 #include <Arduino.h>
 #include <SimpleFOC.h>
+#include <atomic>
 #include <vector>
 
 #include "../configuration.h"
+#include "../i2c_bus.h"
 #include "../logger.h"
+#include "../mailbox.h"
 #include "../proto_gen/smartknob.pb.h"
 #include "../task.h"
+#include "detent_engine.h"
+#include "detent_index.h"
+#include "haptic_sequencer.h"
+#include "motor_timing.h"
+#include "thermal_limiter.h"
 
+// Bulk uploads that must all be delivered in order; configs, haptics and calibration use the lock-free handoffs below
 enum class CommandType
 {
-    CALIBRATE,
-    CONFIG,
-    HAPTIC,
+    HAPTIC_WAVEFORM,
+    DETENT_POSITIONS,
 };
 
 struct HapticData
 {
-    bool press;
-    bool long_press;
+    HapticWaveform waveform;
+    float strength;
+    uint8_t sample_ticks;
+};
+
+struct HapticWaveformUpload
+{
+    uint8_t slot;
+    uint8_t length;
+    int8_t samples[HAPTIC_MAX_SAMPLES];
+    // Played once stored, unless 0
+    float strength;
+    uint8_t sample_ticks;
+};
+
+// Values of PB_MotorCalibState.step
+enum class MotorCalibStep : uint8_t
+{
+    STARTING,
+    SWEEP_FORWARD,
+    SWEEP_BACKWARD,
+    FITTING,
+    DONE,
+    FAILED,
+};
+
+struct LoopTimingStats
+{
+    uint32_t samples;
+    uint32_t min_period_us;
+    uint32_t max_period_us;
+    uint32_t missed_ticks;
+};
+
+// What MotorTask publishes to its listeners. The (much larger) config is only fetched with getConfig() when
+// config_generation changes.
+struct MotorState
+{
+    int32_t current_position;
+    float sub_position_unit;
+    uint32_t config_generation;
 };
 
 struct Command
@@ -28,8 +75,8 @@ struct Command
     union CommandData
     {
         uint8_t unused;
-        PB_SmartKnobConfig config;
-        HapticData haptic;
+        HapticWaveformUpload haptic_waveform;
+        PB_DetentPositions detent_positions;
     };
     CommandData data;
 };
@@ -39,29 +86,115 @@ class MotorTask : public Task<MotorTask>
     friend class Task<MotorTask>; // Allow base Task to invoke protected run()
 
 public:
-    MotorTask(const uint8_t task_core, Configuration &configuration);
+    MotorTask(const uint8_t task_core, Configuration &configuration, I2cBus &i2c_bus);
     ~MotorTask();
 
     void setConfig(const PB_SmartKnobConfig config);
+    // Returns false if the chunk was dropped because too many commands are pending
+    bool setDetentPositions(const PB_DetentPositions &detent_positions);
+    // Whether someone is interacting with the knob (proximity, press, rotation). With SK_MOTOR_IDLE the motor drops to
+    // a reduced FOC rate (less CPU time) and voltage limit (weaker detents, less current under load) while not engaged.
+    void setEngaged(bool engaged);
     void playHaptic(bool press, bool long_press);
+    void playHapticWaveform(HapticWaveform waveform, float strength, uint8_t sample_ticks = 1);
+    // Replace a user waveform (slot 0 is HapticWaveform::USER_0), then play it unless strength is 0. Returns false if
+    // the arguments are invalid or too many commands are pending.
+    bool uploadHapticWaveform(uint8_t slot, const int8_t *samples, uint8_t length, float strength = 0, uint8_t sample_ticks = 1);
+    // Upload and/or play a waveform as requested over the serial protocol; returns false if the request is invalid or
+    // couldn't be queued
+    bool playHapticEffect(const PB_HapticEffect &effect);
     void runCalibration();
+    // Measure step responses to fill the detent gain schedule, then save it to the persistent configuration
+    void runAutotune();
+    // Latest calibration progress, if it changed since generation (which is updated)
+    bool takeCalibState(PB_MotorCalibState &state, uint32_t &generation);
+    // Stage timing since the previous call; returns false if the firmware was built without SK_MOTOR_TIMING
+    bool readTiming(PB_MotorTiming &timing);
+    // ESP32 die temperature, used to derate the motor's continuous rating
+    void setDieTemperature(float celsius);
+    // Latest thermal budget; returns false if the firmware was built without SK_MOTOR_THERMAL_LIMIT
+    bool readThermal(PB_MotorThermal &thermal);
+    // Shaft angle (radians) and torque last commanded by the detent stage; returns false if the firmware was built
+    // without SK_RECORDER_MOTOR
+    bool readMotion(float &angle, float &torque);
 
+    // Listeners receive MotorState updates: immediately on a position or config change, rate limited while the
+    // sub-position moves and at a slow heartbeat otherwise.
     void addListener(QueueHandle_t queue);
+    // Copy the config currently applied by the motor loop and return its generation.
+    uint32_t getConfig(PB_SmartKnobConfig &config);
 
 protected:
     void run();
 
 private:
     Configuration &configuration_;
+    I2cBus &i2c_bus_;
     QueueHandle_t queue_;
+    // Number of commands sent to queue_ but not yet received, so the motor loop can skip polling an empty queue
+    std::atomic<uint32_t> queued_commands_{0};
+    LatestMailbox<PB_SmartKnobConfig> config_mailbox_;
+    MpscRing<HapticData, 8> haptic_ring_;
+    std::atomic<bool> calibration_requested_{false};
+    std::atomic<bool> autotune_requested_{false};
+    PB_MotorCalibState calib_state_ = {};
+    LatestMailbox<PB_MotorCalibState> calib_state_mailbox_;
     std::vector<QueueHandle_t> listeners_;
+    SemaphoreHandle_t config_mutex_;
+    PB_SmartKnobConfig applied_config_ = {};
+    uint32_t config_generation_ = 0;
+    std::atomic<bool> engaged_{true};
     char buf_[72];
 
+    HapticSequencer haptic_;
+    DetentIndex detent_index_;
+#if SK_MOTOR_TIMING
+    MotorTiming timing_;
+#endif
+
     // BLDC motor & driver instance
     BLDCMotor motor = BLDCMotor(1);
     BLDCDriver6PWM driver = BLDCDriver6PWM(PIN_UH, PIN_UL, PIN_VH, PIN_VL, PIN_WH, PIN_WL);
 
-    void publish(const PB_SmartKnobState &state);
+    void publish(const MotorState &state);
+    // Bulk uploads only; returns false without waiting if the queue is full
+    bool sendCommand(const Command &command);
+    void setAppliedConfig(const PB_SmartKnobConfig &config);
+    const DetentIndex *detentIndexFor(const PB_SmartKnobConfig &config) const;
     void calibrate();
+    void failCalibration(const char *reason);
+    void reportCalibration(MotorCalibStep step, float progress);
+    void applyCalibration(const PB_MotorCalibration &calibration);
+    void autotune();
+    bool measureStepResponse(float step, float d, float &overshoot);
     void checkSensorError();
+
+#if SK_MOTOR_IDLE
+    bool idle_ = false;
+
+    void setIdle(bool idle);
+#endif
+
+#if SK_MOTOR_THERMAL_LIMIT
+    std::atomic<float> die_celsius_{0};
+    LatestMailbox<PB_MotorThermal> thermal_mailbox_;
+    uint32_t last_thermal_us_ = 0;
+    uint32_t last_thermal_report_ = 0;
+    uint64_t derated_us_ = 0;
+    bool derate_logged_ = false;
+
+    void updateThermal(ThermalLimiter &thermal);
+#endif
+
+#if SK_RECORDER_MOTOR
+    std::atomic<float> motion_angle_{0};
+    std::atomic<float> motion_torque_{0};
+#endif
+
+#if SK_MOTOR_LOOP_HZ
+    hw_timer_t *loop_timer_ = nullptr;
+
+    void startLoopTimer();
+    void checkLoopTiming(const LoopTimingStats &stats);
+#endif
 };
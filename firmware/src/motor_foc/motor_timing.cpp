@@ -0,0 +1,89 @@
+#include "motor_timing.h"
+
+#if SK_MOTOR_TIMING
+
+static void toStage(const MotorTimingStats &stats, uint32_t bucket_width_cycles, uint32_t cycles_per_us, PB_MotorTimingStage &out)
+{
+    out = {
+        .min_us = stats.count > 0 ? stats.min_cycles / cycles_per_us : 0,
+        .max_us = stats.max_cycles / cycles_per_us,
+        .mean_us = stats.count > 0 ? (float)stats.total_cycles / stats.count / cycles_per_us : 0,
+        .count = stats.count,
+        .bucket_width_us = bucket_width_cycles / cycles_per_us,
+        .histogram_count = MOTOR_TIMING_BUCKETS,
+    };
+    memcpy(out.histogram, stats.histogram, sizeof(out.histogram));
+}
+
+MotorTiming::MotorTiming() : sequence_(0), reset_requested_(false) {}
+
+void MotorTiming::setBucketWidthUs(MotorTimingStage stage, uint32_t bucket_width_us)
+{
+    bucket_width_cycles_[(uint8_t)stage] = max(bucket_width_us, (uint32_t)1) * ESP.getCpuFreqMHz();
+}
+
+void MotorTiming::beginWrite()
+{
+    sequence_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (reset_requested_.exchange(false, std::memory_order_relaxed))
+    {
+        data_ = {};
+    }
+}
+
+void MotorTiming::endWrite()
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MotorTiming::record(MotorTimingStage stage, uint32_t cycles)
+{
+    beginWrite();
+    MotorTimingStats &stats = data_.stages[(uint8_t)stage];
+    stats.min_cycles = stats.count == 0 ? cycles : min(stats.min_cycles, cycles);
+    stats.max_cycles = max(stats.max_cycles, cycles);
+    stats.total_cycles += cycles;
+    stats.count++;
+    uint32_t bucket = cycles / bucket_width_cycles_[(uint8_t)stage];
+    stats.histogram[min(bucket, (uint32_t)MOTOR_TIMING_BUCKETS - 1)]++;
+    endWrite();
+}
+
+void MotorTiming::addMissedTicks(uint32_t missed_ticks)
+{
+    beginWrite();
+    data_.missed_ticks += missed_ticks;
+    endWrite();
+}
+
+void MotorTiming::readAndReset(PB_MotorTiming &out)
+{
+    MotorTimingSnapshot snapshot;
+    uint32_t start;
+    do
+    {
+        start = sequence_.load(std::memory_order_acquire);
+        memcpy(&snapshot, &data_, sizeof(snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((start & 1) != 0 || sequence_.load(std::memory_order_relaxed) != start);
+    reset_requested_.store(true, std::memory_order_relaxed);
+
+    uint32_t cycles_per_us = ESP.getCpuFreqMHz();
+    out = {};
+    out.loop_hz = SK_MOTOR_LOOP_HZ;
+    out.missed_ticks = snapshot.missed_ticks;
+    out.has_period = true;
+    out.has_foc = true;
+    out.has_commands = true;
+    out.has_detent = true;
+    out.has_publish = true;
+    toStage(snapshot.stages[(uint8_t)MotorTimingStage::PERIOD], bucket_width_cycles_[(uint8_t)MotorTimingStage::PERIOD], cycles_per_us, out.period);
+    toStage(snapshot.stages[(uint8_t)MotorTimingStage::FOC], bucket_width_cycles_[(uint8_t)MotorTimingStage::FOC], cycles_per_us, out.foc);
+    toStage(snapshot.stages[(uint8_t)MotorTimingStage::COMMANDS], bucket_width_cycles_[(uint8_t)MotorTimingStage::COMMANDS], cycles_per_us, out.commands);
+    toStage(snapshot.stages[(uint8_t)MotorTimingStage::DETENT], bucket_width_cycles_[(uint8_t)MotorTimingStage::DETENT], cycles_per_us, out.detent);
+    toStage(snapshot.stages[(uint8_t)MotorTimingStage::PUBLISH], bucket_width_cycles_[(uint8_t)MotorTimingStage::PUBLISH], cycles_per_us, out.publish);
+}
+
+#endif
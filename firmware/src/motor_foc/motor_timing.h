@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "../proto_gen/smartknob.pb.h"
+
+static const uint8_t MOTOR_TIMING_BUCKETS = sizeof(PB_MotorTimingStage::histogram) / sizeof(uint32_t);
+
+enum class MotorTimingStage : uint8_t
+{
+    PERIOD,
+    FOC,
+    COMMANDS,
+    DETENT,
+    PUBLISH,
+    COUNT,
+};
+
+struct MotorTimingStats
+{
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t count;
+    uint32_t histogram[MOTOR_TIMING_BUCKETS];
+};
+
+struct MotorTimingSnapshot
+{
+    MotorTimingStats stages[(uint8_t)MotorTimingStage::COUNT];
+    uint32_t missed_ticks;
+};
+
+// Per-stage cycle counts for the motor loop. Written only by the motor task; any other task can take a consistent
+// snapshot without locking (seqlock: the writer bumps the sequence to odd while updating, readers retry if the
+// sequence was odd or changed while they copied).
+class MotorTiming
+{
+public:
+    MotorTiming();
+
+    void setBucketWidthUs(MotorTimingStage stage, uint32_t bucket_width_us);
+
+    // Writer side (motor task only)
+    void record(MotorTimingStage stage, uint32_t cycles);
+    void addMissedTicks(uint32_t missed_ticks);
+
+    // Reader side (any task). Takes a snapshot and asks the writer to start over, so each read covers the time since
+    // the previous one.
+    void readAndReset(PB_MotorTiming &out);
+
+private:
+    std::atomic<uint32_t> sequence_;
+    std::atomic<bool> reset_requested_;
+    MotorTimingSnapshot data_ = {};
+    uint32_t bucket_width_cycles_[(uint8_t)MotorTimingStage::COUNT] = {};
+
+    void beginWrite();
+    void endWrite();
+};
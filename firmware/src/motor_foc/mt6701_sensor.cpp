@@ -1,5 +1,6 @@
 #include "mt6701_sensor.h"
 #include "driver/spi_master.h"
+#include "fast_math.h"
 
 static const float ALPHA = 0.4;
 
@@ -88,52 +89,99 @@ void MT6701Sensor::init()
     spi_transaction_.rxlength = 24;
     spi_transaction_.tx_buffer = NULL;
     spi_transaction_.rx_buffer = NULL;
+
+#if SK_MT6701_TRACKER_HZ
+    tracker_.setBandwidth(SK_MT6701_TRACKER_HZ);
+#endif
 }
 
 float MT6701Sensor::getSensorAngle()
 {
+#if SK_MT6701_ASYNC_SPI
+    // Collect the transfer queued on a previous call (if it has completed) and immediately queue the next one, so the
+    // bus time overlaps with the FOC math instead of blocking it. Until a new sample arrives the previous one is used.
+    if (transaction_pending_)
+    {
+        spi_transaction_t *result;
+        if (spi_device_get_trans_result(spi_device_, &result, 0) == ESP_OK)
+        {
+            transaction_pending_ = false;
+            processSample(result->rx_data);
+        }
+    }
+    if (!transaction_pending_)
+    {
+        esp_err_t ret = spi_device_queue_trans(spi_device_, &spi_transaction_, 0);
+        assert(ret == ESP_OK);
+        transaction_pending_ = true;
+    }
+#else
     uint32_t now = micros();
     if (now - last_update_ > 100)
     {
-
         esp_err_t ret = spi_device_polling_transmit(spi_device_, &spi_transaction_);
         assert(ret == ESP_OK);
+        processSample(spi_transaction_.rx_data);
+        last_update_ = now;
+    }
+#endif
 
-        uint32_t spi_32 = (spi_transaction_.rx_data[0] << 16) | (spi_transaction_.rx_data[1] << 8) | spi_transaction_.rx_data[2];
-        uint32_t angle_spi = spi_32 >> 10;
+#if SK_MT6701_TRACKER_HZ
+    // Extrapolate to now so the sample age doesn't show up as lag
+    return tracker_.angle((micros() - last_sample_us_) * 1e-6f);
+#else
+    float rad = -fastAtan2(y_, x_);
+    if (rad < 0)
+    {
+        rad += 2 * PI;
+    }
+    return angle_correction_.apply(rad);
+#endif
+}
 
-        uint8_t field_status = (spi_32 >> 6) & 0x3;
-        uint8_t push_status = (spi_32 >> 8) & 0x1;
-        uint8_t loss_status = (spi_32 >> 9) & 0x1;
+#if SK_MT6701_TRACKER_HZ
+float MT6701Sensor::getVelocity()
+{
+    return tracker_.velocity();
+}
+#endif
 
-        uint8_t received_crc = spi_32 & 0x3F;
-        uint8_t calculated_crc = CRC6_43_18bit(spi_32 >> 6);
+void MT6701Sensor::processSample(const uint8_t *rx_data)
+{
+    uint32_t spi_32 = (rx_data[0] << 16) | (rx_data[1] << 8) | rx_data[2];
+    uint32_t angle_spi = spi_32 >> 10;
 
-        if (received_crc == calculated_crc)
-        {
-            float new_angle = (float)angle_spi * 2 * PI / 16384;
-            float new_x = cosf(new_angle);
-            float new_y = sinf(new_angle);
-            x_ = new_x * ALPHA + x_ * (1 - ALPHA);
-            y_ = new_y * ALPHA + y_ * (1 - ALPHA);
-        }
-        else
-        {
-            error_ = {
-                .error = true,
-                .received_crc = received_crc,
-                .calculated_crc = calculated_crc,
-            };
-        }
+    uint8_t field_status = (spi_32 >> 6) & 0x3;
+    uint8_t push_status = (spi_32 >> 8) & 0x1;
+    uint8_t loss_status = (spi_32 >> 9) & 0x1;
 
-        last_update_ = now;
+    uint8_t received_crc = spi_32 & 0x3F;
+    uint8_t calculated_crc = CRC6_43_18bit(spi_32 >> 6);
+
+    if (received_crc == calculated_crc)
+    {
+        float new_angle = (float)angle_spi * 2 * PI / 16384;
+#if SK_MT6701_TRACKER_HZ
+        // Negated to match the direction of the EWMA path below
+        float measured = angle_spi == 0 ? 0 : 2 * PI - new_angle;
+        uint32_t now = micros();
+        tracker_.update(angle_correction_.apply(measured), (now - last_sample_us_) * 1e-6f);
+        last_sample_us_ = now;
+#else
+        float new_x, new_y;
+        fastSinCos(new_angle, &new_y, &new_x);
+        x_ = new_x * ALPHA + x_ * (1 - ALPHA);
+        y_ = new_y * ALPHA + y_ * (1 - ALPHA);
+#endif
     }
-    float rad = -atan2f(y_, x_);
-    if (rad < 0)
+    else
     {
-        rad += 2 * PI;
+        error_ = {
+            .error = true,
+            .received_crc = received_crc,
+            .calculated_crc = calculated_crc,
+        };
     }
-    return rad;
 }
 
 MT6701Error MT6701Sensor::getAndClearError()
@@ -143,4 +191,9 @@ MT6701Error MT6701Sensor::getAndClearError()
     return out;
 }
 
+void MT6701Sensor::setAngleCorrection(const float *table, pb_size_t count)
+{
+    angle_correction_.set(table, count);
+}
+
 #endif
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include <SimpleFOC.h>
 #include "driver/spi_master.h"
 
+#include "angle_correction.h"
+#include "angle_tracker.h"
+
 struct MT6701Error {
     bool error;
     uint8_t received_crc;
@@ -22,16 +25,33 @@ class MT6701Sensor : public Sensor {
         //    Calling this method directly does not update the base-class internal fields.
         //    Use update() when calling from outside code.
         float getSensorAngle();
+#if SK_MT6701_TRACKER_HZ
+        // Velocity estimated by the tracking observer instead of differentiating the angle
+        float getVelocity() override;
+#endif
 
         MT6701Error getAndClearError();
+
+        // Correction table measured during motor calibration; pass count 0 to disable (e.g. while calibrating)
+        void setAngleCorrection(const float *table, pb_size_t count);
     private:
 
         spi_device_handle_t spi_device_;
         spi_transaction_t spi_transaction_ = {};
+        bool transaction_pending_ = false;
 
         float x_;
         float y_;
         uint32_t last_update_;
 
         MT6701Error error_ = {};
+
+        AngleCorrection angle_correction_;
+#if SK_MT6701_TRACKER_HZ
+        AngleTracker tracker_;
+        uint32_t last_sample_us_ = 0;
+#endif
+
+        // Check CRC and feed a completed 24-bit transfer into the filter
+        void processSample(const uint8_t *rx_data);
 };
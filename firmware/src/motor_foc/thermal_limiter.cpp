@@ -0,0 +1,41 @@
+#include "thermal_limiter.h"
+#include "../math_util.h"
+
+// Derating starts once half of the budget is used and reaches the minimum scale when it's empty. The minimum keeps
+// some detent feel even when the budget is exhausted; the integrator saturates there rather than cutting torque.
+static const float DERATE_START_BUDGET = 0.5;
+static const float DERATE_MIN_SCALE = 0.3;
+
+// Full continuous rating up to this die temperature, falling linearly to the minimum at the hot end
+static const float DIE_DERATE_START_CELSIUS = 45;
+static const float DIE_DERATE_END_CELSIUS = 85;
+static const float DIE_MIN_FACTOR = 0.25;
+
+ThermalLimiter::ThermalLimiter(float continuous_voltage, float max_voltage, float capacity_seconds)
+    : continuous_voltage_sq_(continuous_voltage * continuous_voltage),
+      capacity_((max_voltage * max_voltage - continuous_voltage * continuous_voltage) * capacity_seconds)
+{
+}
+
+void ThermalLimiter::setDieCelsius(float celsius)
+{
+    die_celsius_ = celsius;
+    float t = (celsius - DIE_DERATE_START_CELSIUS) / (DIE_DERATE_END_CELSIUS - DIE_DERATE_START_CELSIUS);
+    die_factor_ = 1 - CLAMP(t, 0.0f, 1.0f) * (1 - DIE_MIN_FACTOR);
+}
+
+float ThermalLimiter::update(float voltage, float dt_s)
+{
+    heat_ += (voltage * voltage - continuous_voltage_sq_ * die_factor_) * dt_s;
+    heat_ = CLAMP(heat_, 0.0f, capacity_);
+
+    float derate = (DERATE_START_BUDGET - budget()) / DERATE_START_BUDGET;
+    scale_ = 1 - CLAMP(derate, 0.0f, 1.0f) * (1 - DERATE_MIN_SCALE);
+    return scale_;
+}
+
+void ThermalLimiter::reset()
+{
+    heat_ = 0;
+    scale_ = 1;
+}
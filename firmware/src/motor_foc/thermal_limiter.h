@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+// I²t-style estimate of driver/coil heating. With the knob held still (e.g. someone leaning on an endstop) the current
+// is proportional to the commanded voltage, so integrating V² above what the motor can sustain continuously tracks how
+// much of its thermal budget is used up. As the budget drains, the returned scale smoothly reduces the torque the
+// detents may command; it recovers once the load drops back below the continuous rating. No dependency on the motor,
+// sensor or RTOS.
+class ThermalLimiter
+{
+public:
+    // continuous_voltage can be held indefinitely (while the board is cool), and max_voltage for capacity_seconds
+    // starting cold.
+    ThermalLimiter(float continuous_voltage, float max_voltage, float capacity_seconds);
+
+    // The continuous rating is reduced as the ESP32 die temperature rises. It's the only temperature the board measures,
+    // and runs warmer than the air around the knob, so the derating thresholds are set in die temperature.
+    void setDieCelsius(float celsius);
+
+    // Account for voltage being applied for dt_s seconds and return the torque scale to apply from now on.
+    float update(float voltage, float dt_s);
+
+    void reset();
+
+    // Remaining budget, 1 when cold and 0 when exhausted
+    float budget() const
+    {
+        return 1 - heat_ / capacity_;
+    }
+    float scale() const
+    {
+        return scale_;
+    }
+    float dieCelsius() const
+    {
+        return die_celsius_;
+    }
+
+private:
+    const float continuous_voltage_sq_;
+    const float capacity_;
+
+    float die_celsius_ = 0;
+    float die_factor_ = 1;
+    float heat_ = 0;
+    float scale_ = 1;
+};
@@ -1,13 +1,23 @@
 #include "tlv_sensor.h"
+#include "fast_math.h"
 
 static const float ALPHA = 1;
 
 TlvSensor::TlvSensor() {}
 
-void TlvSensor::init(TwoWire* wire, bool invert) {
-  wire_ = wire;
+void TlvSensor::init(I2cBus &bus, bool invert) {
+  bus_ = &bus;
+  device_ = bus.addDevice("TLV493D", I2cPriority::CRITICAL);
   invert_ = invert;
-  tlv_.begin(*wire);
+  begin();
+#if SK_TLV_TRACKER_HZ
+  tracker_.setBandwidth(SK_TLV_TRACKER_HZ);
+#endif
+}
+
+void TlvSensor::begin() {
+  I2cLease lease(*bus_, device_);
+  tlv_.begin(bus_->wire());
   tlv_.setAccessMode(Tlv493d::AccessMode_e::MASTERCONTROLLEDMODE);
   tlv_.disableInterrupt();
   tlv_.disableTemp();
@@ -16,14 +26,25 @@ void TlvSensor::init(TwoWire* wire, bool invert) {
 float TlvSensor::getSensorAngle() {
     uint32_t now = micros();
     if (now - last_update_ > 50) {
-      tlv_.updateData();
+      {
+        I2cLease lease(*bus_, device_);
+        tlv_.updateData();
+      }
       frame_counts_[cur_frame_count_index_] = tlv_.getExpectedFrameCount();
       cur_frame_count_index_++;
       if (cur_frame_count_index_ >= sizeof(frame_counts_)) {
         cur_frame_count_index_ = 0;
       }
+#if SK_TLV_TRACKER_HZ
+      float measured = (invert_ ? -1 : 1) * fastAtan2(tlv_.getY(), tlv_.getX());
+      if (measured < 0) {
+        measured += 2*PI;
+      }
+      tracker_.update(angle_correction_.apply(measured), (now - last_update_) * 1e-6f);
+#else
       x_ = tlv_.getX() * ALPHA + x_ * (1-ALPHA);
       y_ = tlv_.getY() * ALPHA + y_ * (1-ALPHA);
+#endif
       last_update_ = now;
 
       bool all_same = true;
@@ -36,22 +57,37 @@ float TlvSensor::getSensorAngle() {
       }
       if (all_same) {
         error_ = true;
-        init(wire_, invert_);
+        begin();
         // Force unique frame counts to avoid reset loop
         for (uint8_t i = 1; i < sizeof(frame_counts_); i++) {
           frame_counts_[i] = i;
         }
       }
     }
-    float rad = (invert_ ? -1 : 1) * atan2f(y_, x_);
+#if SK_TLV_TRACKER_HZ
+    // Extrapolate to now so the sample age doesn't show up as lag
+    return tracker_.angle((now - last_update_) * 1e-6f);
+#else
+    float rad = (invert_ ? -1 : 1) * fastAtan2(y_, x_);
     if (rad < 0) {
         rad += 2*PI;
     }
-    return rad;
+    return angle_correction_.apply(rad);
+#endif
 }
 
+#if SK_TLV_TRACKER_HZ
+float TlvSensor::getVelocity() {
+  return tracker_.velocity();
+}
+#endif
+
 bool TlvSensor::getAndClearError() {
   bool error = error_;
   error_ = false;
   return error;
 }
+
+void TlvSensor::setAngleCorrection(const float *table, pb_size_t count) {
+  angle_correction_.set(table, count);
+}
@@ -3,12 +3,16 @@
 #include <SimpleFOC.h>
 #include <Tlv493d.h>
 
+#include "../i2c_bus.h"
+#include "angle_correction.h"
+#include "angle_tracker.h"
+
 class TlvSensor : public Sensor {
     public:
         TlvSensor();
 
-        // initialize the sensor hardware
-        void init(TwoWire* wire, bool invert);
+        // initialize the sensor hardware; every read holds the shared bus at critical priority
+        void init(I2cBus &bus, bool invert);
 
         // Get current shaft angle from the sensor hardware, and 
         // return it as a float in radians, in the range 0 to 2PI.
@@ -16,18 +20,33 @@ class TlvSensor : public Sensor {
         //    Calling this method directly does not update the base-class internal fields.
         //    Use update() when calling from outside code.
         float getSensorAngle();
+#if SK_TLV_TRACKER_HZ
+        // Velocity estimated by the tracking observer instead of differentiating the angle
+        float getVelocity() override;
+#endif
 
         bool getAndClearError();
+
+        // Correction table measured during motor calibration; pass count 0 to disable (e.g. while calibrating)
+        void setAngleCorrection(const float *table, pb_size_t count);
     private:
         Tlv493d tlv_ = Tlv493d();
         float x_;
         float y_;
         uint32_t last_update_;
-        TwoWire* wire_;
+        I2cBus* bus_;
+        uint8_t device_;
         bool invert_;
 
         bool error_ = false;
 
         uint8_t frame_counts_[3] = {};
         uint8_t cur_frame_count_index_ = 0;
+
+        AngleCorrection angle_correction_;
+
+        void begin();
+#if SK_TLV_TRACKER_HZ
+        AngleTracker tracker_;
+#endif
 };
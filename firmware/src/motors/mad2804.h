@@ -10,3 +10,7 @@
 
 #define FOC_VOLTAGE_LIMIT 3
 #define FOC_LPF 0.0075
+
+// Thermal budget: voltage that can be held indefinitely, and how long FOC_VOLTAGE_LIMIT can be held from cold
+#define FOC_CONTINUOUS_VOLTAGE 1.5
+#define FOC_THERMAL_CAPACITY_SECONDS 20
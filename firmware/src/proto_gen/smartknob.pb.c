@@ -21,6 +21,21 @@ PB_BIND(PB_MotorCalibState, PB_MotorCalibState, AUTO)
 PB_BIND(PB_StrainCalibState, PB_StrainCalibState, AUTO)
 
 
+PB_BIND(PB_MotorTimingStage, PB_MotorTimingStage, AUTO)
+
+
+PB_BIND(PB_MotorTiming, PB_MotorTiming, 2)
+
+
+PB_BIND(PB_MotorThermal, PB_MotorThermal, AUTO)
+
+
+PB_BIND(PB_SensorSample, PB_SensorSample, AUTO)
+
+
+PB_BIND(PB_SensorRecording, PB_SensorRecording, 2)
+
+
 PB_BIND(PB_Ack, PB_Ack, AUTO)
 
 
@@ -42,12 +57,24 @@ PB_BIND(PB_PersistentConfiguration, PB_PersistentConfiguration, AUTO)
 PB_BIND(PB_MotorCalibration, PB_MotorCalibration, AUTO)
 
 
+PB_BIND(PB_GainSchedule, PB_GainSchedule, AUTO)
+
+
+PB_BIND(PB_GainScheduleEntry, PB_GainScheduleEntry, AUTO)
+
+
 PB_BIND(PB_StrainState, PB_StrainState, AUTO)
 
 
 PB_BIND(PB_StrainCalibration, PB_StrainCalibration, AUTO)
 
 
+PB_BIND(PB_DetentPositions, PB_DetentPositions, 2)
+
+
+PB_BIND(PB_HapticEffect, PB_HapticEffect, AUTO)
+
+
 
 
 
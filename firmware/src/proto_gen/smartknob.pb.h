@@ -22,13 +22,33 @@ typedef enum _PB_LogLevel {
 typedef enum _PB_SmartKnobCommand {
     PB_SmartKnobCommand_GET_KNOB_INFO = 0,
     PB_SmartKnobCommand_MOTOR_CALIBRATE = 1,
-    PB_SmartKnobCommand_STRAIN_CALIBRATE = 2
+    PB_SmartKnobCommand_STRAIN_CALIBRATE = 2,
+    PB_SmartKnobCommand_GET_MOTOR_TIMING = 3,
+    PB_SmartKnobCommand_MOTOR_AUTOTUNE = 4,
+    PB_SmartKnobCommand_GET_MOTOR_THERMAL = 5,
+    /* * Start recording sensor samples into the on-device ring buffer. */
+    PB_SmartKnobCommand_RECORDER_ARM = 6,
+    /* * Stop the armed recorder after its post-trigger window. A strain press also triggers it. */
+    PB_SmartKnobCommand_RECORDER_TRIGGER = 7,
+    /* * Send the stopped recording as SensorRecording chunks. */
+    PB_SmartKnobCommand_RECORDER_DUMP = 8
 } PB_SmartKnobCommand;
 
 /* Struct definitions */
 /* * Motor calibration state information */
 typedef struct _PB_MotorCalibState {
-    bool calibrated; /* * PLACEHOLDER */
+    bool calibrated;
+    /* * Current calibration step: 0 = starting, 1 = sweeping forward, 2 = sweeping backward, 3 = fitting, 4 = done,
+ 5 = failed */
+    uint32_t step;
+    /* * Progress through the current step, 0-1 */
+    float progress;
+    /* * Results, only valid once step is 4 (done) */
+    uint32_t pole_pairs;
+    float zero_electrical_offset;
+    bool direction_cw;
+    /* * Largest sensor angle error found, in radians */
+    float max_angle_error;
 } PB_MotorCalibState;
 
 /* * Strain calibration state information */
@@ -37,6 +57,87 @@ typedef struct _PB_StrainCalibState {
     float strain_scale;
 } PB_StrainCalibState;
 
+/* * Timing statistics for one stage of the motor control loop. */
+typedef struct _PB_MotorTimingStage {
+    uint32_t min_us;
+    uint32_t max_us;
+    float mean_us;
+    uint32_t count;
+    /* * Width of each histogram bucket; the last bucket also counts everything beyond it. */
+    uint32_t bucket_width_us;
+    pb_size_t histogram_count;
+    uint32_t histogram[16];
+} PB_MotorTimingStage;
+
+/* * Motor control loop timing since the previous MotorTiming was requested (via the
+ GET_MOTOR_TIMING command). Only available if the firmware was built with motor timing
+ instrumentation enabled. */
+typedef struct _PB_MotorTiming {
+    /* * Nominal FOC loop rate. */
+    uint32_t loop_hz;
+    /* * Timer ticks the loop didn't get to run for because a previous iteration overran. */
+    uint32_t missed_ticks;
+    /* * Time between consecutive FOC iterations. */
+    bool has_period;
+    PB_MotorTimingStage period;
+    bool has_foc;
+    PB_MotorTimingStage foc;
+    /* * The following stages run once per detent stage tick (every SK_MOTOR_DETENT_DIVIDER FOC iterations). */
+    bool has_commands;
+    PB_MotorTimingStage commands;
+    bool has_detent;
+    PB_MotorTimingStage detent;
+    bool has_publish;
+    PB_MotorTimingStage publish;
+} PB_MotorTiming;
+
+/* * Motor thermal budget, requested via the GET_MOTOR_THERMAL command. Only available if the
+ firmware was built with the thermal limiter enabled. */
+typedef struct _PB_MotorThermal {
+    /* * Remaining I²t budget, 1 when cold and 0 when exhausted. */
+    float budget;
+    /* * Scale currently applied to detent and endstop torque (1 = not derated). */
+    float torque_scale;
+    /* * ESP32 die temperature used to derate the continuous rating. */
+    float die_celsius;
+    /* * Total time spent derating since boot. */
+    uint32_t derated_millis;
+} PB_MotorThermal;
+
+/* * One sample of the on-device sensor recorder. */
+typedef struct _PB_SensorSample {
+    /* * Time of the sample, in microseconds since boot. */
+    uint32_t timestamp_us;
+    /* * Raw HX711 reading. */
+    int32_t strain_raw;
+    /* * Filtered load above the tracked baseline, and the baseline itself (calibrated units). */
+    float strain_load;
+    float strain_baseline;
+    uint32_t proximity_mm;
+    /* * VL53L0X range status, 0 = valid. */
+    uint32_t proximity_status;
+    float lux;
+    /* * ESP32 die temperature. */
+    float temperature_celsius;
+    /* * Only recorded if the firmware was built with SK_RECORDER_MOTOR=1, 0 otherwise. */
+    float motor_angle;
+    float motor_torque;
+} PB_SensorSample;
+
+/* * A chunk of the sensor recording, sent as a sequence of these (in order, oldest samples first)
+ in response to the RECORDER_DUMP command. Only available if the firmware was built with the
+ sensor recorder enabled. */
+typedef struct _PB_SensorRecording {
+    /* * Index of the first sample in this chunk. */
+    uint32_t offset;
+    /* * Total number of samples in the recording. */
+    uint32_t total;
+    /* * Index of the sample recorded when the recording was triggered. */
+    uint32_t trigger_index;
+    pb_size_t samples_count;
+    PB_SensorSample samples[10];
+} PB_SensorRecording;
+
 /* * Lets the host know that a ToSmartknob message was received and should not be retried. */
 typedef struct _PB_Ack {
     uint32_t nonce;
@@ -192,13 +293,38 @@ typedef struct _PB_MotorCalibration {
     float zero_electrical_offset;
     bool direction_cw;
     uint32_t pole_pairs;
+    /* * Sensor angle error (measured minus actual, radians) at evenly spaced raw sensor angles
+ over one mechanical revolution, starting at 0. Compensates magnet eccentricity and
+ sensor nonlinearity. Empty if not measured. */
+    pb_size_t angle_correction_count;
+    float angle_correction[32];
 } PB_MotorCalibration;
 
+typedef struct _PB_GainScheduleEntry {
+    float position_width_radians;
+    /* * Proportional gain per unit of detent_strength_unit */
+    float p;
+    /* * Derivative (damping) gain per unit of detent_strength_unit */
+    float d;
+    /* * Detent torque limit */
+    float torque_limit;
+} PB_GainScheduleEntry;
+
+/* * Detent controller gains keyed on detent width. Gains for widths between entries are interpolated linearly (and held
+ beyond the first/last entry). Empty uses the built-in defaults. Filled per unit by the MOTOR_AUTOTUNE command. */
+typedef struct _PB_GainSchedule {
+    /* * Sorted by position_width_radians */
+    pb_size_t entries_count;
+    PB_GainScheduleEntry entries[8];
+} PB_GainSchedule;
+
 typedef struct _PB_PersistentConfiguration {
     uint32_t version;
     bool has_motor;
     PB_MotorCalibration motor;
     float strain_scale;
+    bool has_gain_schedule;
+    PB_GainSchedule gain_schedule;
 } PB_PersistentConfiguration;
 
 /* * Initial knob information. */
@@ -222,6 +348,9 @@ typedef struct _PB_FromSmartKnob {
         PB_SmartKnobState smartknob_state;
         PB_MotorCalibState motor_calib_state;
         PB_StrainCalibState strain_calib_state;
+        PB_MotorTiming motor_timing;
+        PB_MotorThermal motor_thermal;
+        PB_SensorRecording sensor_recording;
     } payload;
 } PB_FromSmartKnob;
 
@@ -234,6 +363,43 @@ typedef struct _PB_StrainCalibration {
     float calibration_weight;
 } PB_StrainCalibration;
 
+/* * Full set of "magnetic" detent positions for the config with the given id, for sets that
+ don't fit in SmartKnobConfig.detent_positions.
+
+ Either send the positions in order as a sequence of chunks (offset 0 starts a new set,
+ each following chunk must continue where the previous one ended), or describe them with
+ a range rule by setting range_step and leaving positions empty. The set takes effect once
+ all `total` positions have been received and a config with a matching id is applied. */
+typedef struct _PB_DetentPositions {
+    /* * Id of the SmartKnobConfig these positions belong to. Must not be empty. */
+    char config_id[65];
+    /* * Index of the first position in this chunk within the full set. */
+    uint32_t offset;
+    /* * Total number of positions in the full set. */
+    uint32_t total;
+    /* * Positions in this chunk, in any order. */
+    pb_size_t positions_count;
+    int32_t positions[32];
+    /* * Range rule: when range_step is non-zero, positions are range_start + i * range_step for i in [0, total). */
+    int32_t range_start;
+    int32_t range_step;
+} PB_DetentPositions;
+
+typedef PB_BYTES_ARRAY_T(64) PB_HapticEffect_samples_t;
+/* * Play a haptic waveform on top of the detent torque, optionally uploading a custom one first.
+
+ Waveforms: 0 = click, 1 = double click, 2 = buzz, 3 = ramp, 4-7 = user waveforms 0-3. */
+typedef struct _PB_HapticEffect {
+    uint32_t waveform;
+    /* * Torque (as motor voltage) of a full scale sample. 0 only uploads samples without playing them. */
+    float strength;
+    /* * Control ticks (~1ms each) to hold each sample for, 0 is treated as 1. */
+    uint32_t sample_ticks;
+    /* * If not empty, replaces the user waveform selected by `waveform` (which must be 4-7) before playing it.
+ Each byte is a signed sample, -127..127 maps to -strength..strength. */
+    PB_HapticEffect_samples_t samples;
+} PB_HapticEffect;
+
 /* Message TO the Smartknob from the host */
 typedef struct _PB_ToSmartknob {
     uint8_t protocol_version;
@@ -245,6 +411,8 @@ typedef struct _PB_ToSmartknob {
         PB_SmartKnobCommand smartknob_command;
         PB_StrainCalibration strain_calibration;
         SETTINGS_Settings settings;
+        PB_DetentPositions detent_positions;
+        PB_HapticEffect haptic_effect;
     } payload;
 } PB_ToSmartknob;
 
@@ -259,8 +427,8 @@ extern "C" {
 #define _PB_LogLevel_ARRAYSIZE ((PB_LogLevel)(PB_LogLevel_VERBOSE+1))
 
 #define _PB_SmartKnobCommand_MIN PB_SmartKnobCommand_GET_KNOB_INFO
-#define _PB_SmartKnobCommand_MAX PB_SmartKnobCommand_STRAIN_CALIBRATE
-#define _PB_SmartKnobCommand_ARRAYSIZE ((PB_SmartKnobCommand)(PB_SmartKnobCommand_STRAIN_CALIBRATE+1))
+#define _PB_SmartKnobCommand_MAX PB_SmartKnobCommand_RECORDER_DUMP
+#define _PB_SmartKnobCommand_ARRAYSIZE ((PB_SmartKnobCommand)(PB_SmartKnobCommand_RECORDER_DUMP+1))
 
 
 #define PB_ToSmartknob_payload_smartknob_command_ENUMTYPE PB_SmartKnobCommand
@@ -283,36 +451,91 @@ extern "C" {
 #define PB_FromSmartKnob_init_default            {0, 0, {PB_Knob_init_default}}
 #define PB_ToSmartknob_init_default              {0, 0, 0, {PB_RequestState_init_default}}
 #define PB_Knob_init_default                     {"", "", false, PB_PersistentConfiguration_init_default, false, SETTINGS_Settings_init_default}
-#define PB_MotorCalibState_init_default          {0}
+#define PB_MotorCalibState_init_default          {0, 0, 0, 0, 0, 0, 0}
 #define PB_StrainCalibState_init_default         {0, 0}
+#define PB_MotorTimingStage_init_default         {0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define PB_MotorTiming_init_default              {0, 0, false, PB_MotorTimingStage_init_default, false, PB_MotorTimingStage_init_default, false, PB_MotorTimingStage_init_default, false, PB_MotorTimingStage_init_default, false, PB_MotorTimingStage_init_default}
+#define PB_MotorThermal_init_default             {0, 0, 0, 0}
+#define PB_SensorSample_init_default             {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define PB_SensorRecording_init_default          {0, 0, 0, 0, {PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default, PB_SensorSample_init_default}}
 #define PB_Ack_init_default                      {0}
 #define PB_Log_init_default                      {"", _PB_LogLevel_MIN, "", 0}
 #define PB_SmartKnobState_init_default           {0, 0, false, PB_SmartKnobConfig_init_default, 0}
 #define PB_SmartKnobConfig_init_default          {0, 0, 0, 0, 0, 0, 0, 0, 0, "", 0, {0, 0, 0, 0, 0}, 0, 0}
 #define PB_RequestState_init_default             {0}
-#define PB_PersistentConfiguration_init_default  {0, false, PB_MotorCalibration_init_default, 0}
-#define PB_MotorCalibration_init_default         {0, 0, 0, 0}
+#define PB_PersistentConfiguration_init_default  {0, false, PB_MotorCalibration_init_default, 0, false, PB_GainSchedule_init_default}
+#define PB_MotorCalibration_init_default         {0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define PB_GainSchedule_init_default             {0, {PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default, PB_GainScheduleEntry_init_default}}
+#define PB_GainScheduleEntry_init_default        {0, 0, 0, 0}
 #define PB_StrainState_init_default              {0, 0}
 #define PB_StrainCalibration_init_default        {0}
+#define PB_DetentPositions_init_default          {"", 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0}
+#define PB_HapticEffect_init_default             {0, 0, 0, {0, {0}}}
 #define PB_FromSmartKnob_init_zero               {0, 0, {PB_Knob_init_zero}}
 #define PB_ToSmartknob_init_zero                 {0, 0, 0, {PB_RequestState_init_zero}}
 #define PB_Knob_init_zero                        {"", "", false, PB_PersistentConfiguration_init_zero, false, SETTINGS_Settings_init_zero}
-#define PB_MotorCalibState_init_zero             {0}
+#define PB_MotorCalibState_init_zero             {0, 0, 0, 0, 0, 0, 0}
 #define PB_StrainCalibState_init_zero            {0, 0}
+#define PB_MotorTimingStage_init_zero            {0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define PB_MotorTiming_init_zero                 {0, 0, false, PB_MotorTimingStage_init_zero, false, PB_MotorTimingStage_init_zero, false, PB_MotorTimingStage_init_zero, false, PB_MotorTimingStage_init_zero, false, PB_MotorTimingStage_init_zero}
+#define PB_MotorThermal_init_zero                {0, 0, 0, 0}
+#define PB_SensorSample_init_zero                {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define PB_SensorRecording_init_zero             {0, 0, 0, 0, {PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero, PB_SensorSample_init_zero}}
 #define PB_Ack_init_zero                         {0}
 #define PB_Log_init_zero                         {"", _PB_LogLevel_MIN, "", 0}
 #define PB_SmartKnobState_init_zero              {0, 0, false, PB_SmartKnobConfig_init_zero, 0}
 #define PB_SmartKnobConfig_init_zero             {0, 0, 0, 0, 0, 0, 0, 0, 0, "", 0, {0, 0, 0, 0, 0}, 0, 0}
 #define PB_RequestState_init_zero                {0}
-#define PB_PersistentConfiguration_init_zero     {0, false, PB_MotorCalibration_init_zero, 0}
-#define PB_MotorCalibration_init_zero            {0, 0, 0, 0}
+#define PB_PersistentConfiguration_init_zero     {0, false, PB_MotorCalibration_init_zero, 0, false, PB_GainSchedule_init_zero}
+#define PB_MotorCalibration_init_zero            {0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define PB_GainSchedule_init_zero                {0, {PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero, PB_GainScheduleEntry_init_zero}}
+#define PB_GainScheduleEntry_init_zero           {0, 0, 0, 0}
 #define PB_StrainState_init_zero                 {0, 0}
 #define PB_StrainCalibration_init_zero           {0}
+#define PB_DetentPositions_init_zero             {"", 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0}
+#define PB_HapticEffect_init_zero                {0, 0, 0, {0, {0}}}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define PB_MotorCalibState_calibrated_tag        1
+#define PB_MotorCalibState_step_tag              2
+#define PB_MotorCalibState_progress_tag          3
+#define PB_MotorCalibState_pole_pairs_tag        4
+#define PB_MotorCalibState_zero_electrical_offset_tag 5
+#define PB_MotorCalibState_direction_cw_tag      6
+#define PB_MotorCalibState_max_angle_error_tag   7
 #define PB_StrainCalibState_step_tag             1
 #define PB_StrainCalibState_strain_scale_tag     2
+#define PB_MotorTimingStage_min_us_tag           1
+#define PB_MotorTimingStage_max_us_tag           2
+#define PB_MotorTimingStage_mean_us_tag          3
+#define PB_MotorTimingStage_count_tag            4
+#define PB_MotorTimingStage_bucket_width_us_tag  5
+#define PB_MotorTimingStage_histogram_tag        6
+#define PB_MotorTiming_loop_hz_tag               1
+#define PB_MotorTiming_missed_ticks_tag          2
+#define PB_MotorTiming_period_tag                3
+#define PB_MotorTiming_foc_tag                   4
+#define PB_MotorTiming_commands_tag              5
+#define PB_MotorTiming_detent_tag                6
+#define PB_MotorTiming_publish_tag               7
+#define PB_MotorThermal_budget_tag               1
+#define PB_MotorThermal_torque_scale_tag         2
+#define PB_MotorThermal_die_celsius_tag          3
+#define PB_MotorThermal_derated_millis_tag       4
+#define PB_SensorSample_timestamp_us_tag         1
+#define PB_SensorSample_strain_raw_tag           2
+#define PB_SensorSample_strain_load_tag          3
+#define PB_SensorSample_strain_baseline_tag      4
+#define PB_SensorSample_proximity_mm_tag         5
+#define PB_SensorSample_proximity_status_tag     6
+#define PB_SensorSample_lux_tag                  7
+#define PB_SensorSample_temperature_celsius_tag  8
+#define PB_SensorSample_motor_angle_tag          9
+#define PB_SensorSample_motor_torque_tag         10
+#define PB_SensorRecording_offset_tag            1
+#define PB_SensorRecording_total_tag             2
+#define PB_SensorRecording_trigger_index_tag     3
+#define PB_SensorRecording_samples_tag           4
 #define PB_Ack_nonce_tag                         1
 #define PB_Log_msg_tag                           1
 #define PB_Log_level_tag                         2
@@ -339,9 +562,16 @@ extern "C" {
 #define PB_MotorCalibration_zero_electrical_offset_tag 2
 #define PB_MotorCalibration_direction_cw_tag     3
 #define PB_MotorCalibration_pole_pairs_tag       4
+#define PB_MotorCalibration_angle_correction_tag 5
+#define PB_GainScheduleEntry_position_width_radians_tag 1
+#define PB_GainScheduleEntry_p_tag               2
+#define PB_GainScheduleEntry_d_tag               3
+#define PB_GainScheduleEntry_torque_limit_tag    4
+#define PB_GainSchedule_entries_tag              1
 #define PB_PersistentConfiguration_version_tag   1
 #define PB_PersistentConfiguration_motor_tag     2
 #define PB_PersistentConfiguration_strain_scale_tag 3
+#define PB_PersistentConfiguration_gain_schedule_tag 4
 #define PB_Knob_mac_address_tag                  1
 #define PB_Knob_ip_address_tag                   2
 #define PB_Knob_persistent_config_tag            3
@@ -353,9 +583,22 @@ extern "C" {
 #define PB_FromSmartKnob_smartknob_state_tag     6
 #define PB_FromSmartKnob_motor_calib_state_tag   7
 #define PB_FromSmartKnob_strain_calib_state_tag  8
+#define PB_FromSmartKnob_motor_timing_tag        9
+#define PB_FromSmartKnob_motor_thermal_tag       10
+#define PB_FromSmartKnob_sensor_recording_tag    11
 #define PB_StrainState_press_weight_tag          1
 #define PB_StrainState_press_value_tag           2
 #define PB_StrainCalibration_calibration_weight_tag 1
+#define PB_DetentPositions_config_id_tag         1
+#define PB_DetentPositions_offset_tag            2
+#define PB_DetentPositions_total_tag             3
+#define PB_DetentPositions_positions_tag         4
+#define PB_DetentPositions_range_start_tag       5
+#define PB_DetentPositions_range_step_tag        6
+#define PB_HapticEffect_waveform_tag             1
+#define PB_HapticEffect_strength_tag             2
+#define PB_HapticEffect_sample_ticks_tag         3
+#define PB_HapticEffect_samples_tag              4
 #define PB_ToSmartknob_protocol_version_tag      1
 #define PB_ToSmartknob_nonce_tag                 2
 #define PB_ToSmartknob_request_state_tag         3
@@ -363,6 +606,8 @@ extern "C" {
 #define PB_ToSmartknob_smartknob_command_tag     5
 #define PB_ToSmartknob_strain_calibration_tag    6
 #define PB_ToSmartknob_settings_tag              7
+#define PB_ToSmartknob_detent_positions_tag      8
+#define PB_ToSmartknob_haptic_effect_tag         9
 
 /* Struct field encoding specification for nanopb */
 #define PB_FromSmartKnob_FIELDLIST(X, a) \
@@ -372,7 +617,10 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (payload,ack,payload.ack),   4) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,log,payload.log),   5) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,smartknob_state,payload.smartknob_state),   6) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,motor_calib_state,payload.motor_calib_state),   7) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (payload,strain_calib_state,payload.strain_calib_state),   8)
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,strain_calib_state,payload.strain_calib_state),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,motor_timing,payload.motor_timing),   9) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,motor_thermal,payload.motor_thermal),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,sensor_recording,payload.sensor_recording),  11)
 #define PB_FromSmartKnob_CALLBACK NULL
 #define PB_FromSmartKnob_DEFAULT NULL
 #define PB_FromSmartKnob_payload_knob_MSGTYPE PB_Knob
@@ -381,6 +629,9 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (payload,strain_calib_state,payload.strain_ca
 #define PB_FromSmartKnob_payload_smartknob_state_MSGTYPE PB_SmartKnobState
 #define PB_FromSmartKnob_payload_motor_calib_state_MSGTYPE PB_MotorCalibState
 #define PB_FromSmartKnob_payload_strain_calib_state_MSGTYPE PB_StrainCalibState
+#define PB_FromSmartKnob_payload_motor_timing_MSGTYPE PB_MotorTiming
+#define PB_FromSmartKnob_payload_motor_thermal_MSGTYPE PB_MotorThermal
+#define PB_FromSmartKnob_payload_sensor_recording_MSGTYPE PB_SensorRecording
 
 #define PB_ToSmartknob_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   protocol_version,   1) \
@@ -389,13 +640,17 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (payload,request_state,payload.request_state)
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,smartknob_config,payload.smartknob_config),   4) \
 X(a, STATIC,   ONEOF,    UENUM,    (payload,smartknob_command,payload.smartknob_command),   5) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,strain_calibration,payload.strain_calibration),   6) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (payload,settings,payload.settings),   7)
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,settings,payload.settings),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,detent_positions,payload.detent_positions),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,haptic_effect,payload.haptic_effect),   9)
 #define PB_ToSmartknob_CALLBACK NULL
 #define PB_ToSmartknob_DEFAULT NULL
 #define PB_ToSmartknob_payload_request_state_MSGTYPE PB_RequestState
 #define PB_ToSmartknob_payload_smartknob_config_MSGTYPE PB_SmartKnobConfig
 #define PB_ToSmartknob_payload_strain_calibration_MSGTYPE PB_StrainCalibration
 #define PB_ToSmartknob_payload_settings_MSGTYPE SETTINGS_Settings
+#define PB_ToSmartknob_payload_detent_positions_MSGTYPE PB_DetentPositions
+#define PB_ToSmartknob_payload_haptic_effect_MSGTYPE PB_HapticEffect
 
 #define PB_Knob_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, STRING,   mac_address,       1) \
@@ -408,7 +663,13 @@ X(a, STATIC,   OPTIONAL, MESSAGE,  settings,          4)
 #define PB_Knob_settings_MSGTYPE SETTINGS_Settings
 
 #define PB_MotorCalibState_FIELDLIST(X, a) \
-X(a, STATIC,   SINGULAR, BOOL,     calibrated,        1)
+X(a, STATIC,   SINGULAR, BOOL,     calibrated,        1) \
+X(a, STATIC,   SINGULAR, UINT32,   step,              2) \
+X(a, STATIC,   SINGULAR, FLOAT,    progress,          3) \
+X(a, STATIC,   SINGULAR, UINT32,   pole_pairs,        4) \
+X(a, STATIC,   SINGULAR, FLOAT,    zero_electrical_offset,   5) \
+X(a, STATIC,   SINGULAR, BOOL,     direction_cw,      6) \
+X(a, STATIC,   SINGULAR, FLOAT,    max_angle_error,   7)
 #define PB_MotorCalibState_CALLBACK NULL
 #define PB_MotorCalibState_DEFAULT NULL
 
@@ -418,6 +679,63 @@ X(a, STATIC,   SINGULAR, FLOAT,    strain_scale,      2)
 #define PB_StrainCalibState_CALLBACK NULL
 #define PB_StrainCalibState_DEFAULT NULL
 
+#define PB_MotorTimingStage_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   min_us,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   max_us,            2) \
+X(a, STATIC,   SINGULAR, FLOAT,    mean_us,           3) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             4) \
+X(a, STATIC,   SINGULAR, UINT32,   bucket_width_us,   5) \
+X(a, STATIC,   REPEATED, UINT32,   histogram,         6)
+#define PB_MotorTimingStage_CALLBACK NULL
+#define PB_MotorTimingStage_DEFAULT NULL
+
+#define PB_MotorTiming_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   loop_hz,           1) \
+X(a, STATIC,   SINGULAR, UINT32,   missed_ticks,      2) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  period,            3) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  foc,               4) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  commands,          5) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  detent,            6) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  publish,           7)
+#define PB_MotorTiming_CALLBACK NULL
+#define PB_MotorTiming_DEFAULT NULL
+#define PB_MotorTiming_period_MSGTYPE PB_MotorTimingStage
+#define PB_MotorTiming_foc_MSGTYPE PB_MotorTimingStage
+#define PB_MotorTiming_commands_MSGTYPE PB_MotorTimingStage
+#define PB_MotorTiming_detent_MSGTYPE PB_MotorTimingStage
+#define PB_MotorTiming_publish_MSGTYPE PB_MotorTimingStage
+
+#define PB_MotorThermal_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, FLOAT,    budget,            1) \
+X(a, STATIC,   SINGULAR, FLOAT,    torque_scale,      2) \
+X(a, STATIC,   SINGULAR, FLOAT,    die_celsius,       3) \
+X(a, STATIC,   SINGULAR, UINT32,   derated_millis,    4)
+#define PB_MotorThermal_CALLBACK NULL
+#define PB_MotorThermal_DEFAULT NULL
+
+#define PB_SensorSample_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   timestamp_us,      1) \
+X(a, STATIC,   SINGULAR, SINT32,   strain_raw,        2) \
+X(a, STATIC,   SINGULAR, FLOAT,    strain_load,       3) \
+X(a, STATIC,   SINGULAR, FLOAT,    strain_baseline,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   proximity_mm,      5) \
+X(a, STATIC,   SINGULAR, UINT32,   proximity_status,   6) \
+X(a, STATIC,   SINGULAR, FLOAT,    lux,               7) \
+X(a, STATIC,   SINGULAR, FLOAT,    temperature_celsius,   8) \
+X(a, STATIC,   SINGULAR, FLOAT,    motor_angle,       9) \
+X(a, STATIC,   SINGULAR, FLOAT,    motor_torque,     10)
+#define PB_SensorSample_CALLBACK NULL
+#define PB_SensorSample_DEFAULT NULL
+
+#define PB_SensorRecording_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   trigger_index,     3) \
+X(a, STATIC,   REPEATED, MESSAGE,  samples,           4)
+#define PB_SensorRecording_CALLBACK NULL
+#define PB_SensorRecording_DEFAULT NULL
+#define PB_SensorRecording_samples_MSGTYPE PB_SensorSample
+
 #define PB_Ack_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   nonce,             1)
 #define PB_Ack_CALLBACK NULL
@@ -465,19 +783,36 @@ X(a, STATIC,   SINGULAR, INT32,    led_hue,          13)
 #define PB_PersistentConfiguration_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   version,           1) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  motor,             2) \
-X(a, STATIC,   SINGULAR, FLOAT,    strain_scale,      3)
+X(a, STATIC,   SINGULAR, FLOAT,    strain_scale,      3) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  gain_schedule,     4)
 #define PB_PersistentConfiguration_CALLBACK NULL
 #define PB_PersistentConfiguration_DEFAULT NULL
 #define PB_PersistentConfiguration_motor_MSGTYPE PB_MotorCalibration
+#define PB_PersistentConfiguration_gain_schedule_MSGTYPE PB_GainSchedule
 
 #define PB_MotorCalibration_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, BOOL,     calibrated,        1) \
 X(a, STATIC,   SINGULAR, FLOAT,    zero_electrical_offset,   2) \
 X(a, STATIC,   SINGULAR, BOOL,     direction_cw,      3) \
-X(a, STATIC,   SINGULAR, UINT32,   pole_pairs,        4)
+X(a, STATIC,   SINGULAR, UINT32,   pole_pairs,        4) \
+X(a, STATIC,   REPEATED, FLOAT,    angle_correction,   5)
 #define PB_MotorCalibration_CALLBACK NULL
 #define PB_MotorCalibration_DEFAULT NULL
 
+#define PB_GainSchedule_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  entries,           1)
+#define PB_GainSchedule_CALLBACK NULL
+#define PB_GainSchedule_DEFAULT NULL
+#define PB_GainSchedule_entries_MSGTYPE PB_GainScheduleEntry
+
+#define PB_GainScheduleEntry_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, FLOAT,    position_width_radians,   1) \
+X(a, STATIC,   SINGULAR, FLOAT,    p,                 2) \
+X(a, STATIC,   SINGULAR, FLOAT,    d,                 3) \
+X(a, STATIC,   SINGULAR, FLOAT,    torque_limit,      4)
+#define PB_GainScheduleEntry_CALLBACK NULL
+#define PB_GainScheduleEntry_DEFAULT NULL
+
 #define PB_StrainState_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, INT32,    press_weight,      1) \
 X(a, STATIC,   SINGULAR, FLOAT,    press_value,       2)
@@ -489,11 +824,34 @@ X(a, STATIC,   SINGULAR, FLOAT,    calibration_weight,   1)
 #define PB_StrainCalibration_CALLBACK NULL
 #define PB_StrainCalibration_DEFAULT NULL
 
+#define PB_DetentPositions_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   config_id,         1) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            2) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             3) \
+X(a, STATIC,   REPEATED, INT32,    positions,         4) \
+X(a, STATIC,   SINGULAR, INT32,    range_start,       5) \
+X(a, STATIC,   SINGULAR, INT32,    range_step,        6)
+#define PB_DetentPositions_CALLBACK NULL
+#define PB_DetentPositions_DEFAULT NULL
+
+#define PB_HapticEffect_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   waveform,          1) \
+X(a, STATIC,   SINGULAR, FLOAT,    strength,          2) \
+X(a, STATIC,   SINGULAR, UINT32,   sample_ticks,      3) \
+X(a, STATIC,   SINGULAR, BYTES,    samples,           4)
+#define PB_HapticEffect_CALLBACK NULL
+#define PB_HapticEffect_DEFAULT NULL
+
 extern const pb_msgdesc_t PB_FromSmartKnob_msg;
 extern const pb_msgdesc_t PB_ToSmartknob_msg;
 extern const pb_msgdesc_t PB_Knob_msg;
 extern const pb_msgdesc_t PB_MotorCalibState_msg;
 extern const pb_msgdesc_t PB_StrainCalibState_msg;
+extern const pb_msgdesc_t PB_MotorTimingStage_msg;
+extern const pb_msgdesc_t PB_MotorTiming_msg;
+extern const pb_msgdesc_t PB_MotorThermal_msg;
+extern const pb_msgdesc_t PB_SensorSample_msg;
+extern const pb_msgdesc_t PB_SensorRecording_msg;
 extern const pb_msgdesc_t PB_Ack_msg;
 extern const pb_msgdesc_t PB_Log_msg;
 extern const pb_msgdesc_t PB_SmartKnobState_msg;
@@ -501,8 +859,12 @@ extern const pb_msgdesc_t PB_SmartKnobConfig_msg;
 extern const pb_msgdesc_t PB_RequestState_msg;
 extern const pb_msgdesc_t PB_PersistentConfiguration_msg;
 extern const pb_msgdesc_t PB_MotorCalibration_msg;
+extern const pb_msgdesc_t PB_GainSchedule_msg;
+extern const pb_msgdesc_t PB_GainScheduleEntry_msg;
 extern const pb_msgdesc_t PB_StrainState_msg;
 extern const pb_msgdesc_t PB_StrainCalibration_msg;
+extern const pb_msgdesc_t PB_DetentPositions_msg;
+extern const pb_msgdesc_t PB_HapticEffect_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define PB_FromSmartKnob_fields &PB_FromSmartKnob_msg
@@ -510,6 +872,11 @@ extern const pb_msgdesc_t PB_StrainCalibration_msg;
 #define PB_Knob_fields &PB_Knob_msg
 #define PB_MotorCalibState_fields &PB_MotorCalibState_msg
 #define PB_StrainCalibState_fields &PB_StrainCalibState_msg
+#define PB_MotorTimingStage_fields &PB_MotorTimingStage_msg
+#define PB_MotorTiming_fields &PB_MotorTiming_msg
+#define PB_MotorThermal_fields &PB_MotorThermal_msg
+#define PB_SensorSample_fields &PB_SensorSample_msg
+#define PB_SensorRecording_fields &PB_SensorRecording_msg
 #define PB_Ack_fields &PB_Ack_msg
 #define PB_Log_fields &PB_Log_msg
 #define PB_SmartKnobState_fields &PB_SmartKnobState_msg
@@ -517,25 +884,38 @@ extern const pb_msgdesc_t PB_StrainCalibration_msg;
 #define PB_RequestState_fields &PB_RequestState_msg
 #define PB_PersistentConfiguration_fields &PB_PersistentConfiguration_msg
 #define PB_MotorCalibration_fields &PB_MotorCalibration_msg
+#define PB_GainSchedule_fields &PB_GainSchedule_msg
+#define PB_GainScheduleEntry_fields &PB_GainScheduleEntry_msg
 #define PB_StrainState_fields &PB_StrainState_msg
 #define PB_StrainCalibration_fields &PB_StrainCalibration_msg
+#define PB_DetentPositions_fields &PB_DetentPositions_msg
+#define PB_HapticEffect_fields &PB_HapticEffect_msg
 
 /* Maximum encoded size of messages (where known) */
 #define PB_Ack_size                              6
-#define PB_FromSmartKnob_size                    399
-#define PB_Knob_size                             252
+#define PB_DetentPositions_size                  452
+#define PB_FromSmartKnob_size                    653
+#define PB_GainScheduleEntry_size                20
+#define PB_GainSchedule_size                     176
+#define PB_HapticEffect_size                     83
+#define PB_Knob_size                             593
 #define PB_Log_size                              393
-#define PB_MotorCalibState_size                  2
-#define PB_MotorCalibration_size                 15
-#define PB_PersistentConfiguration_size          28
+#define PB_MotorCalibState_size                  31
+#define PB_MotorCalibration_size                 175
+#define PB_MotorThermal_size                     21
+#define PB_MotorTimingStage_size                 125
+#define PB_MotorTiming_size                      647
+#define PB_PersistentConfiguration_size          368
 #define PB_RequestState_size                     0
 #define PB_SMARTKNOB_PB_H_MAX_SIZE               PB_FromSmartKnob_size
+#define PB_SensorRecording_size                  578
+#define PB_SensorSample_size                     54
 #define PB_SmartKnobConfig_size                  198
 #define PB_SmartKnobState_size                   220
 #define PB_StrainCalibState_size                 11
 #define PB_StrainCalibration_size                5
 #define PB_StrainState_size                      16
-#define PB_ToSmartknob_size                      210
+#define PB_ToSmartknob_size                      464
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -45,8 +45,22 @@ RootTask::RootTask(
                                  configuration,
                                  [this](PB_SmartKnobConfig &config)
                                  { applyConfig(config, true); },
+                                 [this](PB_DetentPositions &detent_positions)
+                                 { return motor_task_.setDetentPositions(detent_positions); },
+                                 [this](PB_HapticEffect &effect)
+                                 { return motor_task_.playHapticEffect(effect); },
                                  [this]()
                                  { motor_task_.runCalibration(); },
+                                 [this]()
+                                 { motor_task_.runAutotune(); },
+                                 [this](PB_MotorTiming &timing)
+                                 { return motor_task_.readTiming(timing); },
+                                 [this](PB_MotorThermal &thermal)
+                                 { return motor_task_.readThermal(thermal); },
+                                 [this](PB_SmartKnobCommand command)
+                                 { return command == PB_SmartKnobCommand_RECORDER_ARM ? sensors_task_->armRecorder() : sensors_task_->triggerRecorder(); },
+                                 [this](uint32_t offset, PB_SensorRecording &chunk)
+                                 { return sensors_task_->readRecording(offset, chunk); },
                                  [this](float calibration_weight)
                                  { sensors_task_->factoryStrainCalibrationCallback(calibration_weight); })
 
@@ -61,15 +75,15 @@ RootTask::RootTask(
     app_sync_queue_ = xQueueCreate(2, sizeof(cJSON *));
     assert(app_sync_queue_ != NULL);
 
-    knob_state_queue_ = xQueueCreate(1, sizeof(PB_SmartKnobState));
+    // Before the sensors task starts recording
+    sensors_task_->setMotorTask(&motor_task_);
+
+    knob_state_queue_ = xQueueCreate(1, sizeof(MotorState));
     assert(knob_state_queue_ != NULL);
 
     connectivity_status_queue_ = xQueueCreate(1, sizeof(ConnectivityState));
     assert(connectivity_status_queue_ != NULL);
 
-    sensors_status_queue_ = xQueueCreate(100, sizeof(SensorsState));
-    assert(sensors_status_queue_ != NULL);
-
     mutex_ = xSemaphoreCreateMutex();
     assert(mutex_ != NULL);
 }
@@ -247,20 +261,18 @@ void RootTask::run()
 
     EntityStateUpdate entity_state_update_to_send;
 
-    // Value between [0, 65536] for brightness when not engaging with knob
-    bool isCurrentSubPositionSet = false;
-    float currentSubPosition;
     WiFiEvent wifi_event;
 
     AppState app_state = {};
 
     while (1)
     {
+        // Physical interaction keeps the knob awake for at least the configured screen timeout
+        engagement_estimator_.setHoldTimes(max(KNOB_ENGAGED_TIMEOUT_PHYSICAL, settings_.screen.timeout), max(KNOB_ENGAGED_TIMEOUT_PHYSICAL / 2, settings_.screen.timeout), KNOB_ENGAGED_TIMEOUT_NONE_PHYSICAL);
 
         if (xQueueReceive(trigger_motor_calibration_, &trigger_motor_calibration_event_, 0) == pdTRUE)
         {
-            app_state.screen_state.awake_until = millis() + app_state.screen_state.awake_until;
-            app_state.screen_state.has_been_engaged = true;
+            engagement_estimator_.wake(settings_.screen.timeout, millis());
             motor_task_.runCalibration();
         }
 #if SK_WIFI
@@ -270,8 +282,7 @@ void RootTask::run()
             {
             case ONBOARDING:
                 display_task_->getOnboardingFlow()->handleEvent(wifi_event);
-                app_state.screen_state.awake_until = millis() + 10000; // If in onboarding mode always stay awake.
-                app_state.screen_state.has_been_engaged = true;
+                engagement_estimator_.wake(10000, millis()); // If in onboarding mode always stay awake.
                 break;
             case DEMO:
                 // display_task_->getDemoApps()->handleEvent(wifi_event);
@@ -336,8 +347,7 @@ void RootTask::run()
                 }
                 break;
             case SK_RESET_BUTTON_PRESSED:
-                app_state.screen_state.awake_until = millis() + settings_.screen.timeout;
-                app_state.screen_state.has_been_engaged = true;
+                engagement_estimator_.wake(settings_.screen.timeout, millis());
                 display_task_->getErrorHandlingFlow()
                     ->handleEvent(wifi_event);
                 break;
@@ -365,8 +375,7 @@ void RootTask::run()
             case SK_MQTT_RETRY_LIMIT_REACHED:
             case SK_WIFI_STA_CONNECTION_FAILED:
             case SK_WIFI_STA_RETRY_LIMIT_REACHED:
-                app_state.screen_state.awake_until = millis() + settings_.screen.timeout; // Wake up for 15 seconds after error
-                app_state.screen_state.has_been_engaged = true;
+                engagement_estimator_.wake(settings_.screen.timeout, millis()); // Wake up for 15 seconds after error
                 if (wifi_event.sent_at > task_started_at + 3000) // give stuff 3000ms to connect at start before displaying errors.
                 {
                     display_task_->getErrorHandlingFlow()->handleEvent(wifi_event);
@@ -394,8 +403,7 @@ void RootTask::run()
                 settings_ = configuration_->getSettings();
                 break;
             case SK_STRAIN_CALIBRATION:
-                app_state.screen_state.awake_until = millis() + settings_.screen.timeout; // Wake up for 15 seconds after calibration event.
-                app_state.screen_state.has_been_engaged = true;
+                engagement_estimator_.wake(settings_.screen.timeout, millis()); // Wake up for 15 seconds after calibration event.
                 if (current_protocol_ == &proto_protocol_)
                 {
                     LOGD("Sending strain calib state.");
@@ -410,21 +418,17 @@ void RootTask::run()
             }
         }
 #endif
-        if (xQueueReceive(sensors_status_queue_, &latest_sensors_state_, 0) == pdTRUE)
+        if (sensors_task_->takeState(latest_sensors_state_, sensors_state_generation_))
         {
             app_state.proximiti_state.RangeMilliMeter = latest_sensors_state_.proximity.RangeMilliMeter;
             app_state.proximiti_state.RangeStatus = latest_sensors_state_.proximity.RangeStatus;
+            motor_task_.setDieTemperature(latest_sensors_state_.system.esp32_temperature);
 
-            // wake up the screen
-            // RangeStatus is usually 0,2,4. We want to caputure the level of confidence 0 and 2.
-            // Add motor encoder detection? or disable motor if not "enaged detected presence"
-            if (app_state.proximiti_state.RangeStatus < 3 && app_state.proximiti_state.RangeMilliMeter < 200)
+            // SensorsState is republished with every strain sample, feed each proximity measurement only once
+            if (latest_sensors_state_.proximity.sequence != proximity_sequence_)
             {
-                app_state.screen_state.has_been_engaged = true;
-                if (app_state.screen_state.awake_until < millis() + KNOB_ENGAGED_TIMEOUT_NONE_PHYSICAL) // If half of the time of the last interaction has passed, reset allow for engage to be detected again.
-                {
-                    app_state.screen_state.awake_until = millis() + KNOB_ENGAGED_TIMEOUT_NONE_PHYSICAL;
-                }
+                proximity_sequence_ = latest_sensors_state_.proximity.sequence;
+                engagement_estimator_.addProximity(latest_sensors_state_.proximity, millis());
             }
         }
 
@@ -446,27 +450,20 @@ void RootTask::run()
 #endif
         }
 
-        if (xQueueReceive(knob_state_queue_, &latest_state_, 0) == pdTRUE)
+        MotorState motor_state;
+        if (xQueueReceive(knob_state_queue_, &motor_state, 0) == pdTRUE)
         {
-
-            // The following is a smoothing filter (rounding) on the sub position unit (to avoid flakines).
-            float roundedNewPosition = round(latest_state_.sub_position_unit * 3) / 3.0;
-            // This if is used to understand if we have touched the knob since last state.
-            if (isCurrentSubPositionSet)
+            latest_state_.current_position = motor_state.current_position;
+            latest_state_.sub_position_unit = motor_state.sub_position_unit;
+            // Only copy the config when the motor task applied a new one
+            if (motor_state.config_generation != latest_state_config_generation_)
             {
-                if (currentSubPosition != roundedNewPosition)
-                {
-                    // We set a flag on the object Screen State.
-                    //  Todo: this property should be at app state and not screen state
-                    app_state.screen_state.has_been_engaged = true;
-                    if (app_state.screen_state.awake_until < millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL / 2), settings_.screen.timeout)) // If half of the time of the last interaction has passed, reset allow for engage to be detected again.
-                    {
-                        app_state.screen_state.awake_until = millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL / 2), settings_.screen.timeout); // stay awake for 4 seconds after last interaction
-                    }
-                }
+                latest_state_config_generation_ = motor_task_.getConfig(latest_state_.config);
+                latest_state_.has_config = true;
             }
-            isCurrentSubPositionSet = true;
-            currentSubPosition = roundedNewPosition;
+
+            // Has the knob been turned since the last state
+            engagement_estimator_.addRotation(latest_state_.sub_position_unit, millis());
             app_state.motor_state = latest_state_;
             app_state.os_mode_state = configuration_->getOSConfiguration()->mode;
             switch (app_state.os_mode_state)
@@ -541,6 +538,12 @@ void RootTask::run()
             publishState();
         }
 
+        PB_MotorCalibState motor_calib_state;
+        if (motor_task_.takeCalibState(motor_calib_state, motor_calib_state_generation_) && current_protocol_ == &proto_protocol_)
+        {
+            proto_protocol_.sendMotorCalibState(motor_calib_state);
+        }
+
         current_protocol_->loop();
 
         motor_notifier.loopTick();
@@ -548,20 +551,30 @@ void RootTask::run()
 
         updateHardware(&app_state);
 
-        if (app_state.screen_state.has_been_engaged == true)
+        const EngagementState &engagement = engagement_estimator_.update(millis());
+        app_state.screen_state.has_been_engaged = engagement.level == EngagementLevel::ENGAGED;
+        app_state.screen_state.awake_until = engagement.engaged_until_ms;
+        if (app_state.screen_state.has_been_engaged)
+        {
+            app_state.screen_state.brightness = settings_.screen.max_bright;
+        }
+        if (engagement.level != applied_engagement_level_)
         {
-            if (app_state.screen_state.brightness != settings_.screen.max_bright)
+            LOGD("Engagement %d -> %d", (int)applied_engagement_level_, (int)engagement.level);
+            // Power the strain sensor up as soon as someone approaches, so it has settled by the time they press
+            if (engagement.level == EngagementLevel::IDLE)
             {
-                app_state.screen_state.brightness = settings_.screen.max_bright;
-                sensors_task_->strainPowerUp();
+                sensors_task_->strainPowerDown();
             }
-
-            if (millis() > app_state.screen_state.awake_until)
+            else if (applied_engagement_level_ == EngagementLevel::IDLE)
             {
-                app_state.screen_state.has_been_engaged = false;
-                sensors_task_->strainPowerDown();
+                sensors_task_->strainPowerUp();
             }
+            applied_engagement_level_ = engagement.level;
         }
+        // Wake the motor loop on approach too, so haptics are at full rate on first touch
+        motor_task_.setEngaged(engagement.level != EngagementLevel::IDLE);
+        sensors_task_->setProximityMode(engagement.level == EngagementLevel::ENGAGED ? ProximityMode::PRESENCE : ProximityMode::APPROACH);
 
         delay(10);
     }
@@ -572,20 +585,22 @@ void RootTask::updateHardware(AppState *app_state)
     static bool pressed;
 #if SK_STRAIN
 
-    if (configuration_loaded_)
+    // Button transitions arrive as events so none are missed between loop passes, even ones that last a single sample
+    VirtualButtonEvent button_event;
+    while (sensors_task_->popButtonEvent(button_event))
     {
-        switch (latest_sensors_state_.strain.virtual_button_code)
+        engagement_estimator_.addButton(button_event);
+        if (!configuration_loaded_)
+        {
+            continue;
+        }
+
+        switch (button_event.code)
         {
 
         case VIRTUAL_BUTTON_SHORT_PRESSED:
             if (last_strain_pressed_played_ != VIRTUAL_BUTTON_SHORT_PRESSED)
             {
-                app_state->screen_state.has_been_engaged = true;
-                if (app_state->screen_state.awake_until < millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL / 2), settings_.screen.timeout)) // If half of the time of the last interaction has passed, reset allow for engage to be detected again.
-                {
-                    app_state->screen_state.awake_until = millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL), settings_.screen.timeout); // stay awake for 4 seconds after last interaction
-                }
-
                 LOGD("Handling short press");
                 motor_task_.playHaptic(true, false);
                 last_strain_pressed_played_ = VIRTUAL_BUTTON_SHORT_PRESSED;
@@ -595,12 +610,6 @@ void RootTask::updateHardware(AppState *app_state)
         case VIRTUAL_BUTTON_LONG_PRESSED:
             if (last_strain_pressed_played_ != VIRTUAL_BUTTON_LONG_PRESSED)
             {
-                app_state->screen_state.has_been_engaged = true;
-                if (app_state->screen_state.awake_until < millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL / 2), settings_.screen.timeout)) // If half of the time of the last interaction has passed, reset allow for engage to be detected again.
-                {
-                    app_state->screen_state.awake_until = millis() + max((KNOB_ENGAGED_TIMEOUT_PHYSICAL), settings_.screen.timeout); // stay awake for 4 seconds after last interaction
-                }
-
                 LOGD("Handling long press");
 
                 motor_task_.playHaptic(true, true);
@@ -801,11 +810,6 @@ QueueHandle_t RootTask::getConnectivityStateQueue()
     return connectivity_status_queue_;
 }
 
-QueueHandle_t RootTask::getSensorsStateQueue()
-{
-    return sensors_status_queue_;
-}
-
 QueueHandle_t RootTask::getAppSyncQueue()
 {
     return app_sync_queue_;
@@ -15,6 +15,7 @@
 #include "network/mqtt_task.h"
 #include "led_ring/led_ring_task.h"
 #include "sensors/sensors_task.h"
+#include "engagement_estimator.h"
 #include "error_handling_flow/reset_task.h"
 
 #include "notify/motor_notifier/motor_notifier.h"
@@ -38,7 +39,6 @@ public:
 
     QueueHandle_t getConnectivityStateQueue();
     QueueHandle_t getMqttStateQueue();
-    QueueHandle_t getSensorsStateQueue();
     QueueHandle_t getAppSyncQueue();
     QueueHandle_t getSettingsSyncQueue();
 
@@ -82,12 +82,19 @@ private:
 
     uint8_t last_strain_pressed_played_ = VIRTUAL_BUTTON_IDLE;
 
+    EngagementEstimator engagement_estimator_;
+    EngagementLevel applied_engagement_level_ = EngagementLevel::IDLE;
+
     PB_SmartKnobState latest_state_ = {};
+    uint32_t latest_state_config_generation_ = 0;
+    uint32_t motor_calib_state_generation_ = 0;
     PB_SmartKnobConfig latest_config_ = {};
 
     ConnectivityState latest_connectivity_state_ = {};
     MqttState latest_mqtt_state_ = {};
     SensorsState latest_sensors_state_ = {};
+    uint32_t sensors_state_generation_ = 0;
+    uint32_t proximity_sequence_ = 0;
 
     cJSON *apps_ = NULL;
 
@@ -95,7 +102,6 @@ private:
 
     QueueHandle_t connectivity_status_queue_;
     QueueHandle_t mqtt_status_queue_;
-    QueueHandle_t sensors_status_queue_;
 
     QueueHandle_t app_sync_queue_;
 
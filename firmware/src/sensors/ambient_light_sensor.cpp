@@ -0,0 +1,94 @@
+#include "ambient_light_sensor.h"
+#include "util.h"
+
+struct AlsRange
+{
+    uint8_t gain;
+    uint8_t integration_time;
+    // Gain relative to 1x, and integration time in ms, to scale the raw count to lux
+    float gain_value;
+    uint16_t integration_ms;
+};
+
+// Ordered from least to most sensitive. Gain is raised before the window is lengthened, so readings stay fast for as
+// long as possible.
+static const AlsRange ALS_RANGES[] = {
+    {VEML7700_GAIN_1_8, VEML7700_IT_25MS, 0.125, 25},
+    {VEML7700_GAIN_1_8, VEML7700_IT_50MS, 0.125, 50},
+    {VEML7700_GAIN_1_8, VEML7700_IT_100MS, 0.125, 100},
+    {VEML7700_GAIN_1_4, VEML7700_IT_100MS, 0.25, 100},
+    {VEML7700_GAIN_1, VEML7700_IT_100MS, 1, 100},
+    {VEML7700_GAIN_2, VEML7700_IT_100MS, 2, 100},
+    {VEML7700_GAIN_2, VEML7700_IT_200MS, 2, 200},
+    {VEML7700_GAIN_2, VEML7700_IT_400MS, 2, 400},
+    {VEML7700_GAIN_2, VEML7700_IT_800MS, 2, 800},
+};
+// Start in the middle, it converges within a couple of readings either way
+static const uint8_t ALS_INITIAL_STEP = 4;
+
+// Raw counts outside of this band switch to a more/less sensitive range (each step is at least 2x)
+static const uint16_t ALS_RAW_LOW = 100;
+static const uint16_t ALS_RAW_HIGH = 10000;
+
+// Lux per count at gain 2x and 800ms integration time, as in the Adafruit_VEML7700 driver (0.0576 at 1x and 100ms)
+// that readLux() used before, so readings keep their calibration
+static const float ALS_RESOLUTION_MAX_SENSITIVITY = 0.0036;
+
+bool AmbientLightSensor::begin()
+{
+    ready_ = veml_.begin();
+    if (!ready_)
+    {
+        return false;
+    }
+    applyStep(ALS_INITIAL_STEP);
+    return true;
+}
+
+void AmbientLightSensor::applyStep(uint8_t step)
+{
+    step_ = step;
+    const AlsRange &range = ALS_RANGES[step_];
+
+    // Change settings while shut down so the next result is integrated entirely with them. Results are ready one
+    // window after re-enabling; allow a second one for the power-on delay.
+    veml_.enable(false);
+    veml_.setGain(range.gain);
+    veml_.setIntegrationTime(range.integration_time);
+    veml_.enable(true);
+    next_read_ms_ = millis() + 2 * range.integration_ms;
+}
+
+bool AmbientLightSensor::update()
+{
+    if (!ready_ || (int32_t)(millis() - next_read_ms_) < 0)
+    {
+        return false;
+    }
+
+    const AlsRange &range = ALS_RANGES[step_];
+    uint16_t raw = veml_.readALS();
+
+    if (raw > ALS_RAW_HIGH && step_ > 0)
+    {
+        applyStep(step_ - 1);
+        // A saturated count is useless, but anything else is still a valid (if less precise) reading
+        if (raw == UINT16_MAX)
+        {
+            return false;
+        }
+    }
+    else if (raw < ALS_RAW_LOW && step_ < COUNT_OF(ALS_RANGES) - 1)
+    {
+        applyStep(step_ + 1);
+    }
+    else
+    {
+        next_read_ms_ = millis() + range.integration_ms;
+    }
+
+    float resolution = ALS_RESOLUTION_MAX_SENSITIVITY * (2 / range.gain_value) * (800.0f / range.integration_ms);
+    lux_ = raw * resolution;
+    has_reading_ = true;
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Adafruit_VEML7700.h>
+#include <Arduino.h>
+
+// Non-blocking VEML7700 driver. The sensor integrates continuously; update() only reads a result once the current
+// integration window has elapsed, so it never waits on the sensor. Gain and integration time are auto-ranged so the
+// raw count stays in the sensor's accurate range: short windows in bright light (without saturating), and more gain
+// and longer windows only when it's dark enough to need them.
+class AmbientLightSensor
+{
+public:
+    bool begin();
+
+    // Call every loop iteration; returns true if a new reading is available from lux().
+    bool update();
+
+    bool hasReading() const
+    {
+        return has_reading_;
+    }
+    float lux() const
+    {
+        return lux_;
+    }
+
+private:
+    Adafruit_VEML7700 veml_;
+    bool ready_ = false;
+    uint8_t step_ = 0;
+    uint32_t next_read_ms_ = 0;
+    bool has_reading_ = false;
+    float lux_ = 0;
+
+    void applyStep(uint8_t step);
+};
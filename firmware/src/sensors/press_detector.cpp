@@ -0,0 +1,125 @@
+#include "press_detector.h"
+#include "logging.h"
+
+// Light smoothing at rest, opening up to pass press edges through with little lag
+static const float SMOOTHING_MIN_CUTOFF_HZ = 3;
+static const float SMOOTHING_BETA = 0.02;
+static const float SMOOTHING_DERIVATIVE_CUTOFF_HZ = 5;
+
+// Learn the baseline quickly after a reset before detecting presses
+static const uint32_t SETTLE_US = 500000;
+static const float SETTLE_TAU_S = 0.1;
+// Baseline time constants: within the noise band, for slow drift above it, and below it (the baseline is too high,
+// nothing can pull the knob up)
+static const float BASELINE_TAU_S = 2;
+static const float DRIFT_TAU_S = 60;
+static const float NEGATIVE_TAU_S = 0.5;
+static const float NOISE_TAU_S = 5;
+
+// Samples within this many standard deviations of the baseline count as idle
+static const float IDLE_SIGMA = 4;
+// Thresholds never get closer to the noise than this
+static const float PRESS_SIGMA = 8;
+static const float RELEASE_SIGMA = 4;
+static const float MIN_NOISE = 0.5;
+
+// Nobody holds the knob down this long; the baseline must have stepped (e.g. something resting on it), so re-learn it
+static const uint32_t STUCK_PRESS_US = 20000000;
+// Longer gaps (sensor powered down, samples dropped) don't count as more time for the filters
+static const float MAX_DT_S = 0.1;
+
+static float alphaForTau(float tau_s, float dt_s)
+{
+    return 1 - expf(-dt_s / tau_s);
+}
+
+PressDetector::PressDetector(float press_load, float release_load) : press_load_(press_load),
+                                                                     release_load_(release_load),
+                                                                     smoothing_filter_(SMOOTHING_MIN_CUTOFF_HZ, SMOOTHING_BETA, SMOOTHING_DERIVATIVE_CUTOFF_HZ)
+{
+}
+
+void PressDetector::reset()
+{
+    glitch_filter_.reset();
+    smoothing_filter_.reset();
+    primed_ = false;
+    settled_ = false;
+    pressed_ = false;
+    load_ = 0;
+}
+
+bool PressDetector::update(float value, uint32_t timestamp_us)
+{
+    float sample = glitch_filter_.addSample(value);
+
+    if (!primed_)
+    {
+        primed_ = true;
+        first_us_ = timestamp_us;
+        last_us_ = timestamp_us;
+        baseline_ = smoothing_filter_.addSample(sample, 0);
+        noise_variance_ = MIN_NOISE * MIN_NOISE;
+        return false;
+    }
+
+    float dt_s = min((timestamp_us - last_us_) * 1e-6f, MAX_DT_S);
+    last_us_ = timestamp_us;
+    float filtered = smoothing_filter_.addSample(sample, dt_s);
+
+    if (!settled_)
+    {
+        baseline_ += alphaForTau(SETTLE_TAU_S, dt_s) * (filtered - baseline_);
+        settled_ = timestamp_us - first_us_ > SETTLE_US;
+        return false;
+    }
+
+    load_ = filtered - baseline_;
+    float sigma = noise();
+
+    if (!pressed_)
+    {
+        if (load_ > max(press_load_, PRESS_SIGMA * sigma))
+        {
+            pressed_ = true;
+            pressed_since_us_ = timestamp_us;
+            return true;
+        }
+        trackBaseline(filtered, dt_s);
+        return false;
+    }
+
+    if (load_ < max(release_load_, RELEASE_SIGMA * sigma))
+    {
+        pressed_ = false;
+        return true;
+    }
+    if (timestamp_us - pressed_since_us_ > STUCK_PRESS_US)
+    {
+        LOGW("Strain pressed for over %us, re-learning baseline", STUCK_PRESS_US / 1000000);
+        baseline_ = filtered;
+        load_ = 0;
+        pressed_ = false;
+        return true;
+    }
+    return false;
+}
+
+void PressDetector::trackBaseline(float value, float dt_s)
+{
+    float residual = value - baseline_;
+    if (fabsf(residual) < IDLE_SIGMA * noise())
+    {
+        baseline_ += alphaForTau(BASELINE_TAU_S, dt_s) * residual;
+        noise_variance_ += alphaForTau(NOISE_TAU_S, dt_s) * (residual * residual - noise_variance_);
+        noise_variance_ = max(noise_variance_, MIN_NOISE * MIN_NOISE);
+    }
+    else if (residual < 0)
+    {
+        baseline_ += alphaForTau(NEGATIVE_TAU_S, dt_s) * residual;
+    }
+    else
+    {
+        baseline_ += alphaForTau(DRIFT_TAU_S, dt_s) * residual;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "filters.h"
+
+// Turns the load cell signal into press/release decisions without ever taring.
+//
+// The baseline (the reading with nothing pressing on the knob) is tracked continuously: it follows the signal while
+// it stays within the noise band, creeps after slower drift (temperature, a settling mechanism), and is held while
+// the knob is pressed. The noise floor is estimated from the same idle samples, so the press threshold never drops
+// into the noise and the detector stays put when the signal gets noisier (e.g. motor vibration). Press and release
+// use separate thresholds (hysteresis), and a median-of-3 rejects single-sample glitches that used to be discarded
+// by hand. Every sample costs O(1).
+class PressDetector
+{
+public:
+    // press_load/release_load: load above the baseline, in the units samples are given in (grams once calibrated)
+    PressDetector(float press_load, float release_load);
+
+    // Feed one sample; timestamp_us is when it was taken. Returns true if pressed() changed.
+    bool update(float value, uint32_t timestamp_us);
+
+    // Forget everything and re-learn the baseline from the next samples, e.g. after the scale/offset changed or the
+    // sensor was powered back up
+    void reset();
+
+    bool pressed() const
+    {
+        return pressed_;
+    }
+    // Filtered load above the baseline
+    float load() const
+    {
+        return load_;
+    }
+    float baseline() const
+    {
+        return baseline_;
+    }
+    // Standard deviation of the idle signal
+    float noise() const
+    {
+        return sqrtf(noise_variance_);
+    }
+    // Whether the baseline has been learned and presses are being detected
+    bool settled() const
+    {
+        return settled_;
+    }
+
+private:
+    const float press_load_;
+    const float release_load_;
+
+    MedianFilter<3> glitch_filter_;
+    OneEuroFilter smoothing_filter_;
+
+    bool primed_ = false;
+    bool settled_ = false;
+    bool pressed_ = false;
+    uint32_t first_us_ = 0;
+    uint32_t last_us_ = 0;
+    uint32_t pressed_since_us_ = 0;
+
+    float baseline_ = 0;
+    float noise_variance_ = 0;
+    float load_ = 0;
+
+    void trackBaseline(float value, float dt_s);
+};
@@ -0,0 +1,135 @@
+#include "sensor_recorder.h"
+#include "esp_heap_caps.h"
+#include "logging.h"
+
+static const size_t CHUNK_SAMPLES = sizeof(PB_SensorRecording::samples) / sizeof(PB_SensorRecording::samples[0]);
+
+SensorRecorder::SensorRecorder(uint32_t capacity, uint32_t post_trigger_us) : capacity_(capacity),
+                                                                               post_trigger_us_(post_trigger_us)
+{
+}
+
+SensorRecorder::~SensorRecorder()
+{
+    heap_caps_free(buffer_);
+}
+
+bool SensorRecorder::begin()
+{
+    uint32_t size = capacity_ * sizeof(SensorRecord);
+    buffer_ = (SensorRecord *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (buffer_ == nullptr)
+    {
+        LOGE("Failed to allocate %u bytes of PSRAM for the sensor recorder", size);
+        return false;
+    }
+    LOGD("Sensor recorder ready, %u samples (%u bytes)", capacity_, size);
+    return true;
+}
+
+bool SensorRecorder::arm()
+{
+    if (buffer_ == nullptr)
+    {
+        return false;
+    }
+    trigger_requested_.store(false, std::memory_order_relaxed);
+    arm_requested_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool SensorRecorder::trigger()
+{
+    if (buffer_ == nullptr)
+    {
+        return false;
+    }
+    if (state_.load(std::memory_order_relaxed) != State::ARMED && !arm_requested_.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    trigger_requested_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void SensorRecorder::record(const SensorRecord &record)
+{
+    if (buffer_ == nullptr)
+    {
+        return;
+    }
+
+    if (arm_requested_.exchange(false, std::memory_order_relaxed))
+    {
+        written_ = 0;
+        state_.store(State::ARMED, std::memory_order_relaxed);
+        LOGI("Sensor recorder armed");
+    }
+
+    State state = state_.load(std::memory_order_relaxed);
+    if (state != State::ARMED && state != State::TRIGGERED)
+    {
+        return;
+    }
+
+    if (state == State::ARMED && trigger_requested_.exchange(false, std::memory_order_relaxed))
+    {
+        trigger_written_ = written_;
+        trigger_us_ = record.timestamp_us;
+        state = State::TRIGGERED;
+        state_.store(state, std::memory_order_relaxed);
+        LOGI("Sensor recorder triggered, stopping in %ums", post_trigger_us_ / 1000);
+    }
+
+    buffer_[written_ % capacity_] = record;
+    written_++;
+
+    if (state == State::TRIGGERED && record.timestamp_us - trigger_us_ >= post_trigger_us_)
+    {
+        // Publishes the buffer to readChunk()
+        state_.store(State::STOPPED, std::memory_order_release);
+        LOGI("Sensor recorder stopped, %u samples", min(written_, capacity_));
+    }
+}
+
+bool SensorRecorder::readChunk(uint32_t offset, PB_SensorRecording &chunk)
+{
+    if (buffer_ == nullptr || state_.load(std::memory_order_acquire) != State::STOPPED)
+    {
+        return false;
+    }
+
+    uint32_t total = min(written_, capacity_);
+    if (offset > total)
+    {
+        return false;
+    }
+    uint32_t first = written_ - total;
+
+    chunk.offset = offset;
+    chunk.total = total;
+    // A post-trigger window longer than the buffer overwrites the trigger sample itself
+    chunk.trigger_index = trigger_written_ >= first ? trigger_written_ - first : 0;
+    chunk.samples_count = min((uint32_t)CHUNK_SAMPLES, total - offset);
+    for (pb_size_t i = 0; i < chunk.samples_count; i++)
+    {
+        const SensorRecord &record = buffer_[(first + offset + i) % capacity_];
+        PB_SensorSample &sample = chunk.samples[i];
+        sample.timestamp_us = record.timestamp_us;
+        sample.strain_raw = record.strain_raw;
+        sample.strain_load = record.strain_load;
+        sample.strain_baseline = record.strain_baseline;
+        sample.proximity_mm = record.proximity_mm;
+        sample.proximity_status = record.proximity_status;
+        sample.lux = record.lux;
+        sample.temperature_celsius = record.temperature_celsius;
+#if SK_RECORDER_MOTOR
+        sample.motor_angle = record.motor_angle;
+        sample.motor_torque = record.motor_torque;
+#else
+        sample.motor_angle = 0;
+        sample.motor_torque = 0;
+#endif
+    }
+    return true;
+}
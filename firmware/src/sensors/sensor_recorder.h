@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "../proto_gen/smartknob.pb.h"
+
+struct SensorRecord
+{
+    uint32_t timestamp_us;
+    int32_t strain_raw;
+    float strain_load;
+    float strain_baseline;
+    float lux;
+    float temperature_celsius;
+    uint16_t proximity_mm;
+    uint8_t proximity_status;
+#if SK_RECORDER_MOTOR
+    // Shaft angle in radians and the torque (voltage.q) the detent stage last commanded
+    float motor_angle;
+    float motor_torque;
+#endif
+};
+
+// Flight recorder for the sensors, to capture what led up to (and followed) a misdetected press or a proximity glitch
+// without streaming everything over serial.
+//
+// Once armed, records go into a ring buffer in PSRAM, overwriting the oldest ones. A trigger (a strain press, or the
+// RECORDER_TRIGGER command) keeps recording for post_trigger_us and then stops, so the buffer holds the lead-up and
+// the aftermath; the stopped recording can then be read out in chunks at leisure.
+//
+// Only the recording task calls record(). arm() and trigger() may be called from any task; they are requests the
+// recording task picks up with the next record, so it never has to share the buffer while writing to it. The buffer is
+// only read once recording stopped, and re-arming discards it.
+class SensorRecorder
+{
+public:
+    SensorRecorder(uint32_t capacity, uint32_t post_trigger_us);
+    ~SensorRecorder();
+
+    // Allocate the buffer; returns false (and the recorder stays unavailable) if PSRAM can't fit it
+    bool begin();
+
+    // Both return false if the recorder is unavailable
+    bool arm();
+    bool trigger();
+
+    void record(const SensorRecord &record);
+
+    // Copy the samples starting at offset (oldest first) into chunk; returns false unless recording stopped and offset
+    // is within the recording
+    bool readChunk(uint32_t offset, PB_SensorRecording &chunk);
+
+private:
+    enum class State : uint8_t
+    {
+        IDLE,
+        ARMED,
+        TRIGGERED,
+        STOPPED,
+    };
+
+    const uint32_t capacity_;
+    const uint32_t post_trigger_us_;
+    SensorRecord *buffer_ = nullptr;
+
+    std::atomic<State> state_{State::IDLE};
+    std::atomic<bool> arm_requested_{false};
+    std::atomic<bool> trigger_requested_{false};
+
+    // Records written since armed, including the ones overwritten since
+    uint32_t written_ = 0;
+    uint32_t trigger_written_ = 0;
+    uint32_t trigger_us_ = 0;
+};
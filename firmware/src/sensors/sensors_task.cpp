@@ -1,43 +1,64 @@
 #include "sensors_task.h"
 #include "semaphore_guard.h"
 #include "util.h"
+#include "filters.h"
+#include "../motor_foc/motor_task.h"
 
 // todo: think on thise compilation flags
 
-#if SK_ALS
-#include <Adafruit_VEML7700.h>
-#endif
-
 static const char *TAG = "sensors_task";
 
-SensorsTask::SensorsTask(const uint8_t task_core, Configuration *configuration) : Task{"Sensors", 1024 * 6, 1, task_core}, configuration_(configuration)
+// Bus time budgets per second for the sensor polls, so a misbehaving sensor can't crowd out the others
+static const uint32_t PROXIMITY_BUS_BUDGET_US = 50000;
+static const uint32_t ALS_BUS_BUDGET_US = 20000;
+// While waiting for a proximity result, check for it at most this often
+static const uint32_t PROXIMITY_POLL_INTERVAL_MS = 5;
+// Shortest ALS integration time; polling more often than this can't find anything new
+static const uint32_t ALS_POLL_INTERVAL_MS = 25;
+
+// Strain press/release thresholds, as a fraction of PRESS_WEIGHT above the baseline
+static const float STRAIN_PRESSED = 1.0;
+static const float STRAIN_RELEASED = 0.3;
+// The strain reader (and its DOUT interrupt, which it attaches) stays off the motor loop's core, so clocking out a
+// conversion never delays the motor timer
+static const uint8_t STRAIN_READER_CORE = 0;
+
+SensorsTask::SensorsTask(const uint8_t task_core, Configuration *configuration, I2cBus *i2c_bus) : Task{"Sensors", 1024 * 6, 1, task_core},
+                                                                                                      i2c_bus_(i2c_bus),
+#if SK_STRAIN
+                                                                                                      strain(PIN_STRAIN_DO, PIN_STRAIN_SCK, STRAIN_READER_CORE),
+                                                                                                      press_detector_(PRESS_WEIGHT * STRAIN_PRESSED, PRESS_WEIGHT * STRAIN_RELEASED),
+#endif
+#if SK_RECORDER
+                                                                                                      recorder_(SK_RECORDER_SAMPLES, SK_RECORDER_POST_TRIGGER_MS * 1000),
+#endif
+                                                                                                      configuration_(configuration)
 {
     mutex_ = xSemaphoreCreateMutex();
-
-    sensors_state_queue_ = xQueueCreate(50, sizeof(SensorsState));
-    assert(sensors_state_queue_ != NULL);
     assert(mutex_ != NULL);
 }
 
 SensorsTask::~SensorsTask()
 {
-    vQueueDelete(sensors_state_queue_);
-
     vSemaphoreDelete(mutex_);
 }
 
 void SensorsTask::run()
 {
 
-    Wire.begin(PIN_SDA, PIN_SCL);
-    // TODO make this configurable
-    Wire.setClock(400000);
+    // Sensor I²C traffic goes through the bus task: setup here holds the bus directly, polling is queued as jobs
+    proximity_device_ = i2c_bus_->addDevice("VL53L0X", I2cPriority::NORMAL, PROXIMITY_BUS_BUDGET_US);
+#if SK_ALS
+    als_device_ = i2c_bus_->addDevice("VEML7700", I2cPriority::BACKGROUND, ALS_BUS_BUDGET_US);
+#endif
 
-    Adafruit_VL53L0X lox = Adafruit_VL53L0X();
+#if SK_RECORDER
+    recorder_.begin();
+#endif
 
 #if SK_STRAIN
-    strain.begin(PIN_STRAIN_DO, PIN_STRAIN_SCK);
-    while (!strain.is_ready())
+    strain.begin();
+    while (!strain.waitReady(100))
     {
         LOGV(PB_LogLevel_DEBUG, "Strain sensor not ready, waiting...");
         delay(100);
@@ -51,93 +72,82 @@ void SensorsTask::run()
         calibration_scale_ = configuration_->get().strain_scale;
     }
     LOGV(PB_LogLevel_DEBUG, "Strain scale set at boot, %f", calibration_scale_);
-    strain.set_scale(calibration_scale_);
-    delay(100);
-    strain.set_offset(0);
-    strain.tare();
-    delay(100);
+    strain.setScale(calibration_scale_);
+    // No tare, the press detector learns the baseline from the first samples
+    strain.setOffset(0);
 
     strain_powered = true;
-    raw_initial_value_ = strain.get_units(10);
 #endif
 
 #if SK_ALS
-    Adafruit_VEML7700 veml = Adafruit_VEML7700();
     float luminosity_adjustment = 1.00;
     const float LUX_ALPHA = 0.005;
 
     float sum = 0.0;
-    float lux_avg;
+    float lux_avg = 0.0;
     float lux = 0.0;
 
-    if (veml.begin())
-    {
-        veml.setGain(VEML7700_GAIN_2);
-        veml.setIntegrationTime(VEML7700_IT_400MS);
-    }
-    else
+    // Readings arrive from the loop once the first integration window has elapsed
     {
-        LOGE("Failed to boot VEML7700");
+        I2cLease lease(*i2c_bus_, als_device_);
+        if (!als_.begin())
+        {
+            LOGE("Failed to boot VEML7700");
+        }
     }
 
-    delay(1000); // Wait for VEML7700 to boot 500ms seems to not be enough...
-    lux = veml.readLux();
-    MovingAverage lux_filter(10);
-    for (uint8_t i = 0; i < 10; i++)
-    {
-        lux_filter.addSample(lux);
-    }
+    MovingAverage<10> lux_filter;
+    bool lux_filter_primed = false;
+    bool has_lux = false;
+    uint32_t lux_mailbox_generation = 0;
+    unsigned long last_als_poll_ms = 0;
 
 #endif
 
-    if (lox.begin())
+    // The VL53L0X ranges continuously on its own; the loop only checks whether a new result is ready, which is a single
+    // register read, instead of blocking for a full single-shot measurement. Configuring and starting the ranging is left
+    // to the polling jobs.
+    //
+    // begin() can't be split up: the driver runs the sensor's reference SPAD and temperature calibration in one go,
+    // which holds the bus for a few ranging cycles (logged below, and counted in the bus stats). That only happens once
+    // at boot, but on TLV builds the motor loop's angle reads wait for it.
     {
-        VL53L0X_RangingMeasurementData_t measure;
-        lox.rangingTest(&measure, false);
-        LOGD("Proximity range %d, distance %dmm\n", measure.RangeStatus, measure.RangeMilliMeter);
-    }
-    else
-    {
-        LOGE("Failed to boot VL53L0X");
+        I2cLease lease(*i2c_bus_, proximity_device_);
+        uint32_t start_us = micros();
+        if (lox_.begin())
+        {
+            proximity_step_ = ProximityStep::CONFIGURE;
+        }
+        else
+        {
+            LOGE("Failed to boot VL53L0X");
+        }
+        LOGD("VL53L0X boot held the bus for %uus", micros() - start_us);
     }
 
-    VL53L0X_RangingMeasurementData_t measure;
-    lox.rangingTest(&measure, false);
+    ProximityState proximity = {};
+    uint32_t proximity_mailbox_generation = 0;
     unsigned long last_proximity_check_ms = 0;
-    unsigned long last_strain_check_ms = 0;
-    unsigned long last_tare_ms = 0;
+    unsigned long last_proximity_poll_ms = 0;
     unsigned long last_illumination_check_ms = 0;
 
     unsigned long log_ms = 0;
     unsigned long log_ms_strain = 0;
 
-    const uint8_t proximity_poling_rate_hz = 20;
-    const uint8_t strain_poling_rate_hz = 120;
     const uint8_t illumination_poling_rate_hz = 1;
 
-    // How far button is pressed, in range [0, 1]
-    float press_value_unit = 0;
-    float strain_reading_raw = 0;
-
     char buf_[128];
 
     // strain sensor and buttons
     unsigned long short_pressed_triggered_at_ms = 0;
     const unsigned long long_press_timeout_ms = 500;
 
-    // strain breaking points
-    const float strain_released = 0.3;
-    const float strain_pressed = 1.0;
-
-    // strain value filtering
-    double strain_filtered;
-    MovingAverage strain_filter(10);
-
     // system temperature
     long last_system_temperature_check = 0;
     float last_system_temperature = 0;
 
-    uint8_t discarded_strain_reading_count = 0;
+    StrainSample strain_sample;
+    unsigned long last_strain_sample_ms = millis();
 
     while (1)
     {
@@ -150,167 +160,146 @@ void SensorsTask::run()
             last_system_temperature_check = millis();
         }
 
-        if (millis() - last_proximity_check_ms > 1000 / proximity_poling_rate_hz)
+        // No point asking the sensor before the next result can be due
+        uint16_t proximity_period_ms = proximity_mode_.load(std::memory_order_relaxed) == ProximityMode::APPROACH ? SK_PROXIMITY_FAST_PERIOD_MS : SK_PROXIMITY_LONG_RANGE_PERIOD_MS;
+        if (!proximity_job_pending_.load(std::memory_order_acquire) && millis() - last_proximity_check_ms >= proximity_period_ms && millis() - last_proximity_poll_ms >= PROXIMITY_POLL_INTERVAL_MS)
         {
-
-            lox.rangingTest(&measure, false);
-
-            sensors_state.proximity.RangeMilliMeter = measure.RangeMilliMeter - PROXIMITY_SENSOR_OFFSET_MM;
-            sensors_state.proximity.RangeStatus = measure.RangeStatus;
+            proximity_job_pending_.store(true, std::memory_order_relaxed);
+            if (!i2c_bus_->submit({.device = proximity_device_, .run = proximityJob, .done = proximityJobDone, .context = this}))
+            {
+                proximity_job_pending_.store(false, std::memory_order_relaxed);
+            }
+            last_proximity_poll_ms = millis();
+        }
+        if (proximity_mailbox_.take(proximity, proximity_mailbox_generation))
+        {
+            sensors_state.proximity.RangeMilliMeter = proximity.RangeMilliMeter - PROXIMITY_SENSOR_OFFSET_MM;
+            sensors_state.proximity.RangeStatus = proximity.RangeStatus;
+            sensors_state.proximity.sequence++;
             // todo: call this once per tick
             publishState(sensors_state);
             last_proximity_check_ms = millis();
         }
 #if SK_STRAIN
-        if (millis() - last_strain_check_ms > 1000 / strain_poling_rate_hz)
+        // Samples are read by StrainReader as soon as each conversion is ready; handle whatever arrived since the last
+        // pass without waiting for the next one
+        while (strain.popSample(strain_sample))
         {
-            if (strain_powered && strain.wait_ready_timeout(100))
+            last_strain_sample_ms = millis();
+
+            if (calibration_scale_ == 1.0f && strain.getScale() == 1.0f && factory_strain_calibration_step_ == 0)
             {
-                if (calibration_scale_ == 1.0f && strain.get_scale() == 1.0f && factory_strain_calibration_step_ == 0)
+                if (millis() - log_ms_strain > 2000)
                 {
                     LOGI("Strain sensor needs Factory Calibration, press 'Y' to begin!");
-                    delay(2000);
-                    do_strain = false;
-                }
-                else if (weight_measurement_step_ != 0 || factory_strain_calibration_step_ != 0)
-                {
-                    delay(100);
-                    do_strain = false;
+                    log_ms_strain = millis();
                 }
+                continue;
+            }
+            if (weight_measurement_step_ != 0 || factory_strain_calibration_step_ != 0)
+            {
+                // Calibration changes the scale and offset, start over once it's done
+                press_detector_.reset();
+                continue;
+            }
+            if (strain_rebaseline_requested_.exchange(false, std::memory_order_relaxed))
+            {
+                press_detector_.reset();
+            }
 
-                if (do_strain)
-                {
-
-                    strain_reading_raw = strain.get_units(1);
+#if SK_RECORDER
+            last_strain_raw_ = strain_sample.raw;
+#endif
+            bool press_changed = press_detector_.update(strain.toUnits(strain_sample.raw), strain_sample.timestamp_us);
+            sensors_state.strain.raw_value = press_detector_.load();
+            sensors_state.strain.press_value = press_detector_.load() / PRESS_WEIGHT;
 
-                    if (abs(last_strain_reading_raw_ - strain_reading_raw) > 2000)
-                    {
-                        discarded_strain_reading_count++;
-                        if (discarded_strain_reading_count > 20)
-                        {
-                            LOGV(PB_LogLevel_WARNING, "Resetting strain sensor. 20 consecutive readings discarded.");
-                            strain.power_down();
-                            delay(100);
-                            strain.power_up();
-                            delay(100);
-                            strain.set_offset(0);
-                            strain.tare();
-                            delay(100);
-                            discarded_strain_reading_count = 0;
-                        }
-
-                        LOGW("Discarding strain reading, too big difference from last reading.");
-                        LOGV(PB_LogLevel_WARNING, "Current raw strain reading: %f", strain_reading_raw);
-                        LOGV(PB_LogLevel_WARNING, "Last raw strain reading: %f", last_strain_reading_raw_);
-                    }
-                    else
+            if (press_detector_.pressed())
+            {
+                switch (sensors_state.strain.virtual_button_code)
+                {
+                case VIRTUAL_BUTTON_IDLE:
+                    LOGD("Strain sensor short press.");
+                    LOGD("Press value: %f", sensors_state.strain.press_value);
+                    LOGD("Baseline: %f, noise: %f", press_detector_.baseline(), press_detector_.noise());
+                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_SHORT_PRESSED;
+                    short_pressed_triggered_at_ms = millis();
+                    break;
+                case VIRTUAL_BUTTON_SHORT_PRESSED:
+                    if (short_pressed_triggered_at_ms > 0 && millis() - short_pressed_triggered_at_ms > long_press_timeout_ms)
                     {
-                        discarded_strain_reading_count = 0;
-                        sensors_state.strain.raw_value = strain_filter.addSample(strain_reading_raw);
-
-                        // LOGD("Strain raw reading: %f", sensors_state.strain.raw_value);
-
-                        // TODO: calibrate and track (long term moving average) idle point (lower)
-                        sensors_state.strain.press_value = lerp(sensors_state.strain.raw_value, 0, PRESS_WEIGHT, 0, 1);
-
-                        if (sensors_state.strain.press_value < strain_released)
-                        {
-                            // released
-                            switch (sensors_state.strain.virtual_button_code)
-                            {
-                            case VIRTUAL_BUTTON_SHORT_PRESSED:
-                                short_pressed_triggered_at_ms = 0;
-                                sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_SHORT_RELEASED;
-                                break;
-                            case VIRTUAL_BUTTON_LONG_PRESSED:
-                                short_pressed_triggered_at_ms = 0;
-                                sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_LONG_RELEASED;
-                                break;
-                            default:
-                                short_pressed_triggered_at_ms = 0;
-                                sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_IDLE;
-                                delay(20);
-                                break;
-                            }
-                        }
-                        else if (strain_released < sensors_state.strain.press_value && sensors_state.strain.press_value < strain_pressed)
-                        {
-                            switch (sensors_state.strain.virtual_button_code)
-                            {
-
-                            case VIRTUAL_BUTTON_SHORT_PRESSED:
-                                if (short_pressed_triggered_at_ms > 0 && millis() - short_pressed_triggered_at_ms > long_press_timeout_ms)
-                                {
-                                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_LONG_PRESSED;
-                                }
-                                break;
-
-                            default:
-                                break;
-                            }
-                        }
-                        else if (sensors_state.strain.press_value > strain_pressed)
-                        {
-
-                            switch (sensors_state.strain.virtual_button_code)
-                            {
-                            case VIRTUAL_BUTTON_IDLE:
-                                LOGD("Strain sensor short press.");
-                                LOGD("Press value: %f", sensors_state.strain.press_value);
-                                LOGD("Raw value: %f", sensors_state.strain.raw_value);
-                                LOGD("Last press value: %f", last_press_value_);
-                                sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_SHORT_PRESSED;
-                                short_pressed_triggered_at_ms = millis();
-                                break;
-                            case VIRTUAL_BUTTON_SHORT_PRESSED:
-                                if (short_pressed_triggered_at_ms > 0 && millis() - short_pressed_triggered_at_ms > long_press_timeout_ms)
-                                {
-                                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_LONG_PRESSED;
-                                }
-                                break;
-                            default:
-                                break;
-                            }
-                        }
-
-                        publishState(sensors_state);
-
-                        if (sensors_state.strain.virtual_button_code == VIRTUAL_BUTTON_IDLE && millis() - short_pressed_triggered_at_ms > 100 && press_value_unit < strain_released && 0.025 < abs(sensors_state.strain.press_value - last_press_value_) < 0.1 && millis() - last_tare_ms > 10000)
-                        {
-                            LOGV(PB_LogLevel_DEBUG, "Strain sensor tare.");
-                            strain.tare();
-                            last_tare_ms = millis();
-                        }
-
-                        last_strain_reading_raw_ = strain_reading_raw;
-                        last_press_value_ = sensors_state.strain.press_value;
-                        last_strain_check_ms = millis();
+                        sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_LONG_PRESSED;
                     }
+                    break;
+                default:
+                    break;
                 }
-
-                do_strain = true;
             }
             else
             {
-                if (do_strain && strain_powered && millis() - log_ms_strain > 4000)
+                // released
+                switch (sensors_state.strain.virtual_button_code)
                 {
-                    LOGV(PB_LogLevel_DEBUG, "Strain sensor not ready, waiting...");
-                    log_ms_strain = millis();
-                }
-                else if (millis() - log_ms_strain > 4000)
-                {
-                    LOGV(PB_LogLevel_DEBUG, "Strain sensor is disabled. (Might be because of factory calib or its powered off because no engagement of knob)");
-                    log_ms_strain = millis();
+                case VIRTUAL_BUTTON_SHORT_PRESSED:
+                    short_pressed_triggered_at_ms = 0;
+                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_SHORT_RELEASED;
+                    break;
+                case VIRTUAL_BUTTON_LONG_PRESSED:
+                    short_pressed_triggered_at_ms = 0;
+                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_LONG_RELEASED;
+                    break;
+                default:
+                    short_pressed_triggered_at_ms = 0;
+                    sensors_state.strain.virtual_button_code = VIRTUAL_BUTTON_IDLE;
+                    break;
                 }
             }
+            if (press_changed && !press_detector_.pressed())
+            {
+                LOGD("Strain sensor released.");
+            }
+
+            publishState(sensors_state);
+        }
+
+        if (millis() - last_strain_sample_ms > 4000 && millis() - log_ms_strain > 4000)
+        {
+            if (strain_powered)
+            {
+                LOGV(PB_LogLevel_DEBUG, "Strain sensor not ready, waiting...");
+            }
+            else
+            {
+                LOGV(PB_LogLevel_DEBUG, "Strain sensor is disabled. (Might be because of factory calib or its powered off because no engagement of knob)");
+            }
+            log_ms_strain = millis();
         }
 #endif
 
 #if SK_ALS
-        if (millis() - last_illumination_check_ms > 1000 / illumination_poling_rate_hz)
+        if (!als_job_pending_.load(std::memory_order_acquire) && millis() - last_als_poll_ms >= ALS_POLL_INTERVAL_MS)
+        {
+            als_job_pending_.store(true, std::memory_order_relaxed);
+            if (!i2c_bus_->submit({.device = als_device_, .run = ambientLightJob, .done = ambientLightJobDone, .context = this}))
+            {
+                als_job_pending_.store(false, std::memory_order_relaxed);
+            }
+            last_als_poll_ms = millis();
+        }
+        float new_lux;
+        if (lux_mailbox_.take(new_lux, lux_mailbox_generation))
+        {
+            lux = new_lux;
+            has_lux = true;
+        }
+        if (has_lux && millis() - last_illumination_check_ms > 1000 / illumination_poling_rate_hz)
         {
 
-            lux = veml.readLux();
+            if (!lux_filter_primed)
+            {
+                lux_filter.fill(lux);
+                lux_filter_primed = true;
+            }
 
             lux_avg = lux_filter.addSample(lux);
 
@@ -327,9 +316,9 @@ void SensorsTask::run()
         if (millis() - log_ms > 1000)
         {
             LOGV(PB_LogLevel_DEBUG, "System temp %0.2f °C", last_system_temperature);
-            LOGV(PB_LogLevel_DEBUG, "Proximity sensor:  range %d, distance %dmm", measure.RangeStatus, measure.RangeMilliMeter);
+            LOGV(PB_LogLevel_DEBUG, "Proximity sensor:  range %d, distance %dmm", proximity.RangeStatus, proximity.RangeMilliMeter);
 #if SK_STRAIN
-            LOGV(PB_LogLevel_DEBUG, "Strain: reading:\n        Virtual button code: %d\n        Strain value: %f\n        Press value: %f", sensors_state.strain.virtual_button_code, sensors_state.strain.raw_value, press_value_unit);
+            LOGV(PB_LogLevel_DEBUG, "Strain: reading:\n        Virtual button code: %d\n        Strain value: %f\n        Press value: %f\n        Baseline: %f\n        Noise: %f", sensors_state.strain.virtual_button_code, sensors_state.strain.raw_value, sensors_state.strain.press_value, press_detector_.baseline(), press_detector_.noise());
 #endif
 #if SK_ALS
             LOGV(PB_LogLevel_DEBUG, "Illumination sensor: millilux: %.2f, avg %.2f, adj %.2f", lux * 1000, lux_avg * 1000, luminosity_adjustment);
@@ -356,14 +345,14 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
 
         delay(200);
 
-        strain.set_scale();
+        strain.setScale();
         delay(200);
 
-        strain.set_offset(0);
+        strain.setOffset(0);
         strain.tare();
         delay(200);
 
-        raw_initial_value_ = strain.get_units(10);
+        raw_initial_value_ = strain.getUnits(10);
 
         LOGI("Place calibration weight on the knob and press 'Y' again");
 
@@ -375,7 +364,7 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
     float calibration_scale_validation[3];
 
     LOGI("Factory strain calibration step 2, try: %d", factory_strain_calibration_step_);
-    float raw_value = strain.get_units(10);
+    float raw_value = strain.getUnits(10);
 
     LOGD("Raw value: %0.2f", raw_value);
     LOGD("Raw initial value: %0.2f", raw_initial_value_);
@@ -392,9 +381,9 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
             calibration_scale_ = configuration_->get().strain_scale;
         }
         LOGV(PB_LogLevel_DEBUG, "Strain scale set at boot, %f", calibration_scale_);
-        strain.set_scale(calibration_scale_);
+        strain.setScale(calibration_scale_);
         delay(100);
-        strain.set_offset(0);
+        strain.setOffset(0);
         strain.tare();
         delay(100);
 
@@ -406,15 +395,15 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
 
     for (size_t i = 0; i < 3; i++)
     {
-        strain.set_scale();
+        strain.setScale();
         delay(100);
-        raw_value = strain.get_units(10);
+        raw_value = strain.getUnits(10);
         LOGD("Raw value during calibration: %0.2f", raw_value);
         calibration_scale_ = raw_value / calibration_weight;
 
-        strain.set_scale(calibration_scale_);
+        strain.setScale(calibration_scale_);
         delay(200);
-        float calibrated_weight = strain.get_units(10);
+        float calibrated_weight = strain.getUnits(10);
 
         while (abs(calibrated_weight - calibration_weight) > 0.25)
         {
@@ -422,7 +411,7 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
             {
                 LOGE("Calibrated weight is more than 10g off from the calibration weight. Restart calibration by pressing 'Y' again.");
                 delay(2000);
-                strain.set_scale(1.0f);
+                strain.setScale(1.0f);
                 calibration_scale_ = 1.0f;
                 factory_strain_calibration_step_ = 0;
                 return;
@@ -437,16 +426,16 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
                 calibration_scale_ += abs((calibrated_weight - calibration_weight));
             }
 
-            strain.set_scale(calibration_scale_);
+            strain.setScale(calibration_scale_);
             delay(200);
-            calibrated_weight = strain.get_units(10);
+            calibrated_weight = strain.getUnits(10);
             LOGD("Measured weight during calibration: %0.2fg", calibrated_weight); // MAKE VERBOSE LATER
         }
         LOGD("Validation run %d, result: %0.2fg", i + 1, calibrated_weight);
         calibration_scale_validation[i] = calibration_scale_;
     }
 
-    strain.set_scale((calibration_scale_validation[0] + calibration_scale_validation[1] + calibration_scale_validation[2]) / 3.0f);
+    strain.setScale((calibration_scale_validation[0] + calibration_scale_validation[1] + calibration_scale_validation[2]) / 3.0f);
 
     configuration_->saveFactoryStrainCalibration((calibration_scale_validation[0] + calibration_scale_validation[1] + calibration_scale_validation[2]) / 3.0f);
 
@@ -455,12 +444,12 @@ void SensorsTask::factoryStrainCalibrationCallback(float calibration_weight)
     for (size_t i = 0; i < 3; i++)
     {
         delay(1000);
-        LOGD("Verify calibrated weight: %0.0fg", strain.get_units(10));
+        LOGD("Verify calibrated weight: %0.0fg", strain.getUnits(10));
     }
     LOGI("\nRemove calibration weight.\n");
     delay(8000);
     LOGI("Factory strain calibration complete!");
-    strain.set_offset(0);
+    strain.setOffset(0);
     strain.tare();
     factory_strain_calibration_step_ = 0;
 }
@@ -472,12 +461,12 @@ void SensorsTask::weightMeasurementCallback()
         weight_measurement_step_ = 1;
         LOGI("Weight measurement step 1: Place weight on KNOB and press 'U' again");
         delay(1000);
-        strain.set_offset(0);
+        strain.setOffset(0);
         strain.tare();
     }
     else if (weight_measurement_step_ == 1)
     {
-        LOGD("Measured weight: %0.0fg", strain.get_units(10));
+        LOGD("Measured weight: %0.0fg", strain.getUnits(10));
         weight_measurement_step_ = 0;
     }
 }
@@ -485,7 +474,7 @@ void SensorsTask::weightMeasurementCallback()
 bool SensorsTask::powerDownAllowed()
 {
     // If strain sensor isnt calibrated dont allow power down.
-    if (calibration_scale_ == 1.0f && strain.get_scale() == 1.0f)
+    if (calibration_scale_ == 1.0f && strain.getScale() == 1.0f)
     {
         return false;
     }
@@ -507,27 +496,26 @@ void SensorsTask::strainPowerDown()
         return;
     }
 
-    if (strain.wait_ready_timeout(10)) // Make sure sensor is on before powering down.
+    if (strain.isPowered())
     {
         LOGV(PB_LogLevel_DEBUG, "Strain sensor power down.");
 
         strain_powered = false;
-        strain.power_down();
+        strain.powerDown();
     }
 }
 
 void SensorsTask::strainPowerUp() // Delays caused a perceived delay in the activation of strain.
 {
-    if (!strain.wait_ready_timeout(10)) // Make sure sensor is off before powering up.
+    if (!strain_powered)
     {
         LOGV(PB_LogLevel_DEBUG, "Strain sensor power up.");
 
-        strain.power_up();
-        if (strain.wait_ready_timeout(100))
+        strain.powerUp();
+        if (strain.waitReady(100))
         {
-            strain.set_offset(0);
-            strain.tare();
-            last_strain_reading_raw_ = strain.get_units(10);
+            // The baseline may have moved while powered down; re-learn it instead of taring
+            strain_rebaseline_requested_.store(true, std::memory_order_relaxed);
             strain_powered = true;
         }
         else
@@ -538,19 +526,191 @@ void SensorsTask::strainPowerUp() // Delays caused a perceived delay in the acti
 }
 #endif
 
-void SensorsTask::addStateListener(QueueHandle_t queue)
+void SensorsTask::setProximityMode(ProximityMode mode)
+{
+    proximity_mode_.store(mode, std::memory_order_relaxed);
+}
+
+bool SensorsTask::proximityJob(void *context)
+{
+    SensorsTask *task = static_cast<SensorsTask *>(context);
+
+    if (task->proximity_step_ == ProximityStep::RANGING && task->proximity_mode_.load(std::memory_order_relaxed) != task->applied_proximity_mode_)
+    {
+        task->proximity_step_ = ProximityStep::STOP;
+    }
+    if (task->proximity_step_ == ProximityStep::FAILED)
+    {
+        return false;
+    }
+    if (task->proximity_step_ != ProximityStep::RANGING)
+    {
+        // One step per job, the next one follows with the next poll
+        return task->runProximityStep();
+    }
+
+    if (task->lox_.isRangeComplete())
+    {
+        uint16_t range_mm = task->lox_.readRangeResult();
+        task->proximity_mailbox_.put({
+            .RangeMilliMeter = range_mm,
+            .RangeStatus = task->lox_.readRangeStatus(),
+        });
+    }
+    return true;
+}
+
+void SensorsTask::proximityJobDone(void *context, I2cResult result)
+{
+    static_cast<SensorsTask *>(context)->proximity_job_pending_.store(false, std::memory_order_release);
+}
+
+#if SK_ALS
+bool SensorsTask::ambientLightJob(void *context)
 {
-    state_listeners_.push_back(queue);
+    SensorsTask *task = static_cast<SensorsTask *>(context);
+    if (task->als_.update())
+    {
+        task->lux_mailbox_.put(task->als_.lux());
+    }
+    return true;
+}
+
+void SensorsTask::ambientLightJobDone(void *context, I2cResult result)
+{
+    static_cast<SensorsTask *>(context)->als_job_pending_.store(false, std::memory_order_release);
+}
+#endif
+
+bool SensorsTask::runProximityStep()
+{
+    bool approach = applied_proximity_mode_ == ProximityMode::APPROACH;
+    uint16_t period_ms = approach ? SK_PROXIMITY_FAST_PERIOD_MS : SK_PROXIMITY_LONG_RANGE_PERIOD_MS;
+    bool ok = true;
+    switch (proximity_step_)
+    {
+    case ProximityStep::STOP:
+        lox_.stopRangeContinuous();
+        proximity_step_ = ProximityStep::CONFIGURE;
+        break;
+    case ProximityStep::CONFIGURE:
+        // Whatever mode was requested by now; a later change restarts the steps once this one is ranging
+        applied_proximity_mode_ = proximity_mode_.load(std::memory_order_relaxed);
+        approach = applied_proximity_mode_ == ProximityMode::APPROACH;
+        ok = lox_.configSensor(approach ? Adafruit_VL53L0X::VL53L0X_SENSE_HIGH_SPEED : Adafruit_VL53L0X::VL53L0X_SENSE_LONG_RANGE);
+        proximity_step_ = ProximityStep::SET_TIMING_BUDGET;
+        break;
+    case ProximityStep::SET_TIMING_BUDGET:
+        ok = lox_.setMeasurementTimingBudgetMicroSeconds(approach ? SK_PROXIMITY_FAST_BUDGET_US : SK_PROXIMITY_LONG_RANGE_BUDGET_US);
+        proximity_step_ = ProximityStep::START;
+        break;
+    case ProximityStep::START:
+        ok = lox_.startRangeContinuous(period_ms);
+        proximity_step_ = ProximityStep::RANGING;
+        if (ok)
+        {
+            LOGD("Proximity ranging every %ums (%s)", period_ms, approach ? "approach" : "presence");
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (!ok)
+    {
+        LOGE("Failed to start VL53L0X continuous ranging");
+        proximity_step_ = ProximityStep::FAILED;
+    }
+    return ok;
+}
+
+bool SensorsTask::takeState(SensorsState &state, uint32_t &generation)
+{
+    return state_mailbox_.take(state, generation);
+}
+
+bool SensorsTask::popButtonEvent(VirtualButtonEvent &event)
+{
+    return button_events_.pop(event);
 }
 
 void SensorsTask::publishState(const SensorsState &state)
 {
-    for (auto listener : state_listeners_)
+    state_mailbox_.put(state);
+
+    if (state.strain.virtual_button_code != published_button_code_)
     {
-        xQueueSend(listener, &state, portMAX_DELAY);
+        if (!button_events_.push({.code = state.strain.virtual_button_code, .at_ms = millis()}))
+        {
+            LOGW("Virtual button event queue full, dropping event");
+        }
+        published_button_code_ = state.strain.virtual_button_code;
+#if SK_RECORDER
+        // Presses are what the recorder is usually after, stop around the first one once armed
+        if (published_button_code_ == VIRTUAL_BUTTON_SHORT_PRESSED)
+        {
+            recorder_.trigger();
+        }
+#endif
+    }
 
-        // xQueueOverwrite(listener, &state);
+#if SK_RECORDER
+    SensorRecord record = {
+        .timestamp_us = micros(),
+        .strain_raw = last_strain_raw_,
+        .strain_load = state.strain.raw_value,
+#if SK_STRAIN
+        .strain_baseline = press_detector_.baseline(),
+#else
+        .strain_baseline = 0,
+#endif
+        .lux = state.illumination.lux,
+        .temperature_celsius = state.system.esp32_temperature,
+        .proximity_mm = state.proximity.RangeMilliMeter,
+        .proximity_status = state.proximity.RangeStatus,
+    };
+#if SK_RECORDER_MOTOR
+    if (motor_task_ != nullptr)
+    {
+        motor_task_->readMotion(record.motor_angle, record.motor_torque);
     }
+#endif
+    recorder_.record(record);
+#endif
+}
+
+bool SensorsTask::armRecorder()
+{
+#if SK_RECORDER
+    return recorder_.arm();
+#else
+    return false;
+#endif
+}
+
+bool SensorsTask::triggerRecorder()
+{
+#if SK_RECORDER
+    return recorder_.trigger();
+#else
+    return false;
+#endif
+}
+
+bool SensorsTask::readRecording(uint32_t offset, PB_SensorRecording &chunk)
+{
+#if SK_RECORDER
+    return recorder_.readChunk(offset, chunk);
+#else
+    return false;
+#endif
+}
+
+void SensorsTask::setMotorTask(MotorTask *motor_task)
+{
+#if SK_RECORDER
+    motor_task_ = motor_task;
+#endif
 }
 
 void SensorsTask::setSharedEventsQueue(QueueHandle_t shared_events_queue)
@@ -3,26 +3,48 @@
 #include "logger.h"
 #include "task.h"
 #include "app_config.h"
-#include <vector>
+#include "i2c_bus.h"
+#include "mailbox.h"
+#include <atomic>
 #include <Adafruit_VL53L0X.h>
 
 #if SK_STRAIN
-#include <HX711.h>
+#include "press_detector.h"
+#include "strain_reader.h"
+#endif
+#if SK_ALS
+#include "ambient_light_sensor.h"
+#endif
+#if SK_RECORDER
+#include "sensor_recorder.h"
 #endif
 
 #include "driver/temp_sensor.h"
 
 const uint16_t PROXIMITY_SENSOR_OFFSET_MM = 10;
 
+class MotorTask;
+
+enum class ProximityMode : uint8_t
+{
+    // Short timing budget, ranging back to back, so an approaching hand wakes the knob right away
+    APPROACH,
+    // Long range profile at a relaxed rate, enough to tell someone is still in front of the knob
+    PRESENCE,
+};
+
 class SensorsTask : public Task<SensorsTask>
 {
     friend class Task<SensorsTask>; // Allow base Task to invoke protected run()
 
 public:
-    SensorsTask(const uint8_t task_core, Configuration *configuration);
+    SensorsTask(const uint8_t task_core, Configuration *configuration, I2cBus *i2c_bus);
     ~SensorsTask();
 
-    void addStateListener(QueueHandle_t queue);
+    // Copy the latest sensors state if it changed since generation (O(1), never blocks the sensors task)
+    bool takeState(SensorsState &state, uint32_t &generation);
+    // Virtual button code transitions in order, for the one task that handles them
+    bool popButtonEvent(VirtualButtonEvent &event);
     void factoryStrainCalibrationCallback(float calibration_weight);
     void weightMeasurementCallback();
 
@@ -31,27 +53,83 @@ public:
 
     bool powerDownAllowed();
 
+    // Switch the proximity sensor's ranging profile; takes effect on the sensors task's next pass
+    void setProximityMode(ProximityMode mode);
+
     void strainPowerDown();
     void strainPowerUp();
 
+    // Sensor recorder; all return false if the firmware was built without SK_RECORDER or the buffer didn't fit in PSRAM
+    bool armRecorder();
+    bool triggerRecorder();
+    // Only once the recording stopped, see SensorRecorder::readChunk
+    bool readRecording(uint32_t offset, PB_SensorRecording &chunk);
+    // Source of the recorded motor angle and torque; must be set before begin()
+    void setMotorTask(MotorTask *motor_task);
+
 protected:
     void run();
 
 private:
     SensorsState sensors_state = {};
-    QueueHandle_t sensors_state_queue_;
+    LatestMailbox<SensorsState> state_mailbox_;
+    MpscRing<VirtualButtonEvent, 16> button_events_;
+    uint8_t published_button_code_ = VIRTUAL_BUTTON_IDLE;
 
-    bool do_strain = false;
     bool strain_powered = false;
 
     QueueHandle_t shared_events_queue;
 
-    std::vector<QueueHandle_t> state_listeners_;
-
     SemaphoreHandle_t mutex_;
+    std::atomic<ProximityMode> proximity_mode_{ProximityMode::APPROACH};
+
+    I2cBus *i2c_bus_;
+
+    // Steps of (re)starting continuous ranging in applied_proximity_mode_. Each one runs as its own bus job, so a mode
+    // switch never holds the bus for more than a single driver call.
+    enum class ProximityStep : uint8_t
+    {
+        STOP,
+        CONFIGURE,
+        SET_TIMING_BUDGET,
+        START,
+        RANGING,
+        FAILED,
+    };
+
+    // Proximity/ALS polling runs as jobs on the I²C bus task; results are handed back through the mailboxes
+    uint8_t proximity_device_;
+    Adafruit_VL53L0X lox_;
+    ProximityStep proximity_step_ = ProximityStep::FAILED;
+    ProximityMode applied_proximity_mode_ = ProximityMode::APPROACH;
+    std::atomic<bool> proximity_job_pending_{false};
+    LatestMailbox<ProximityState> proximity_mailbox_;
+#if SK_ALS
+    uint8_t als_device_;
+    AmbientLightSensor als_;
+    std::atomic<bool> als_job_pending_{false};
+    LatestMailbox<float> lux_mailbox_;
+#endif
+
+    // Run the next step of starting continuous ranging; returns false if it failed
+    bool runProximityStep();
+    static bool proximityJob(void *context);
+    static void proximityJobDone(void *context, I2cResult result);
+#if SK_ALS
+    static bool ambientLightJob(void *context);
+    static void ambientLightJobDone(void *context, I2cResult result);
+#endif
     void publishState(const SensorsState &state);
 #if SK_STRAIN
-    HX711 strain;
+    StrainReader strain;
+    PressDetector press_detector_;
+    // Set from other tasks when the detector should re-learn the baseline, e.g. after powering the sensor back up
+    std::atomic<bool> strain_rebaseline_requested_{false};
+#endif
+#if SK_RECORDER
+    SensorRecorder recorder_;
+    int32_t last_strain_raw_ = 0;
+    MotorTask *motor_task_ = nullptr;
 #endif
 
     Configuration *configuration_;
@@ -59,9 +137,6 @@ private:
     uint8_t factory_strain_calibration_step_ = 0;
     uint8_t weight_measurement_step_ = 0;
 
-    float last_press_value_ = 0;
-    float last_strain_reading_raw_ = 0;
-
     float raw_initial_value_ = 0;
 
     float calibration_scale_ = 0;
@@ -0,0 +1,214 @@
+#include "strain_reader.h"
+#include "logging.h"
+
+// Runs briefly once per conversion and must get to the bits before the next one, so it preempts the sensors loop
+static const UBaseType_t STRAIN_READER_PRIORITY = 3;
+// Read anyway if no interrupt arrives for this long, in case an edge was missed while the previous result was clocked out
+static const TickType_t DATA_READY_TIMEOUT_TICKS = pdMS_TO_TICKS(200);
+// Channel A at gain 128: one extra clock pulse after the 24 data bits
+static const uint8_t GAIN_PULSES = 1;
+
+// Conversions arrive every 12.5ms (80 SPS) or 100ms (10 SPS); samples older than this mean the HX711 is off or stuck
+static const uint32_t SAMPLE_STALE_MILLIS = 150;
+static const uint32_t BLOCKING_SAMPLE_TIMEOUT_MILLIS = 200;
+
+StrainReader::StrainReader(uint8_t pin_dout, uint8_t pin_sck, const uint8_t task_core) : Task("StrainReader", 2048, STRAIN_READER_PRIORITY, task_core),
+                                                                                         pin_dout_(pin_dout),
+                                                                                         pin_sck_(pin_sck)
+{
+}
+
+void IRAM_ATTR StrainReader::onDataReady(void *arg)
+{
+    StrainReader *reader = static_cast<StrainReader *>(arg);
+    reader->ready_us_ = micros();
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(reader->getHandle(), &higher_priority_task_woken);
+    if (higher_priority_task_woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void StrainReader::run()
+{
+    pinMode(pin_sck_, OUTPUT);
+    digitalWrite(pin_sck_, LOW);
+    pinMode(pin_dout_, INPUT);
+    attachInterruptArg(digitalPinToInterrupt(pin_dout_), onDataReady, this, FALLING);
+
+    while (1)
+    {
+        bool notified = ulTaskNotifyTake(pdTRUE, DATA_READY_TIMEOUT_TICKS) > 0;
+        uint32_t timestamp_us = notified ? ready_us_ : micros();
+
+        int32_t raw;
+        if (!readConversion(raw))
+        {
+            continue;
+        }
+        // Clocking the result out toggles DOUT, so drop the notifications that caused
+        ulTaskNotifyTake(pdTRUE, 0);
+
+        StrainSample sample = {
+            .raw = raw,
+            .timestamp_us = timestamp_us,
+        };
+        // If the ring is full the consumer has fallen behind and the newest sample is dropped
+        samples_.push(sample);
+        latest_.put(sample);
+    }
+}
+
+bool StrainReader::readConversion(int32_t &raw)
+{
+    uint32_t value = 0;
+
+    if (!powered_.load(std::memory_order_relaxed) || digitalRead(pin_dout_) != LOW)
+    {
+        return false;
+    }
+    // SCK must not stay high for more than 60us or the HX711 powers down, so only each high half of a pulse (~2us)
+    // runs with interrupts masked; SCK may stay low for as long as the read gets preempted
+    for (uint8_t i = 0; i < 24 + GAIN_PULSES; i++)
+    {
+        portENTER_CRITICAL(&mux_);
+        // powerDown() may have raised SCK in between two pulses
+        if (!powered_.load(std::memory_order_relaxed))
+        {
+            portEXIT_CRITICAL(&mux_);
+            return false;
+        }
+        digitalWrite(pin_sck_, HIGH);
+        delayMicroseconds(1);
+        if (i < 24)
+        {
+            value = (value << 1) | digitalRead(pin_dout_);
+        }
+        digitalWrite(pin_sck_, LOW);
+        portEXIT_CRITICAL(&mux_);
+        delayMicroseconds(1);
+    }
+
+    // Sign extend the 24-bit two's complement result
+    raw = (int32_t)(value << 8) >> 8;
+    return true;
+}
+
+bool StrainReader::popSample(StrainSample &sample)
+{
+    return samples_.pop(sample);
+}
+
+float StrainReader::toUnits(int32_t raw) const
+{
+    return (raw - offset_.load(std::memory_order_relaxed)) / scale_.load(std::memory_order_relaxed);
+}
+
+bool StrainReader::waitReady(uint32_t timeout_ms)
+{
+    uint32_t start = millis();
+    while (1)
+    {
+        StrainSample sample;
+        uint32_t generation = 0;
+        if (latest_.take(sample, generation) && micros() - sample.timestamp_us < SAMPLE_STALE_MILLIS * 1000)
+        {
+            return true;
+        }
+        if (millis() - start >= timeout_ms)
+        {
+            return false;
+        }
+        delay(1);
+    }
+}
+
+bool StrainReader::readAverage(float &average, uint8_t times)
+{
+    uint32_t generation = latest_.generation();
+    int64_t sum = 0;
+    for (uint8_t i = 0; i < times; i++)
+    {
+        StrainSample sample;
+        uint32_t start = millis();
+        while (!latest_.take(sample, generation))
+        {
+            if (millis() - start > BLOCKING_SAMPLE_TIMEOUT_MILLIS)
+            {
+                return false;
+            }
+            delay(1);
+        }
+        sum += sample.raw;
+    }
+
+    average = (float)sum / times;
+    return true;
+}
+
+float StrainReader::getUnits(uint8_t times)
+{
+    float average;
+    if (!readAverage(average, times))
+    {
+        LOGW("Timed out waiting for strain samples");
+        return 0;
+    }
+    return (average - offset_.load(std::memory_order_relaxed)) / scale_.load(std::memory_order_relaxed);
+}
+
+void StrainReader::tare(uint8_t times)
+{
+    float average;
+    if (!readAverage(average, times))
+    {
+        LOGW("Timed out waiting for strain samples, not tared");
+        return;
+    }
+    setOffset((int32_t)average);
+}
+
+void StrainReader::setScale(float scale)
+{
+    scale_.store(scale, std::memory_order_relaxed);
+}
+
+float StrainReader::getScale() const
+{
+    return scale_.load(std::memory_order_relaxed);
+}
+
+void StrainReader::setOffset(int32_t offset)
+{
+    offset_.store(offset, std::memory_order_relaxed);
+}
+
+int32_t StrainReader::getOffset() const
+{
+    return offset_.load(std::memory_order_relaxed);
+}
+
+void StrainReader::powerDown()
+{
+    // Holding SCK high for more than 60us powers the HX711 down
+    portENTER_CRITICAL(&mux_);
+    powered_.store(false, std::memory_order_relaxed);
+    digitalWrite(pin_sck_, LOW);
+    digitalWrite(pin_sck_, HIGH);
+    portEXIT_CRITICAL(&mux_);
+}
+
+void StrainReader::powerUp()
+{
+    portENTER_CRITICAL(&mux_);
+    digitalWrite(pin_sck_, LOW);
+    powered_.store(true, std::memory_order_relaxed);
+    portEXIT_CRITICAL(&mux_);
+}
+
+bool StrainReader::isPowered() const
+{
+    return powered_.load(std::memory_order_relaxed);
+}
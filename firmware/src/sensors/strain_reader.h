@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "mailbox.h"
+#include "task.h"
+
+struct StrainSample
+{
+    int32_t raw;
+    // When the HX711 signalled the conversion was ready
+    uint32_t timestamp_us;
+};
+
+// Reads the HX711 load cell amplifier as soon as each conversion is ready, instead of polling it. DOUT going low
+// (data ready) fires an interrupt that wakes this task, which bit-bangs the 24-bit result and pushes it to a ring
+// buffer, so the sensors loop never waits on the HX711 and a press is seen within one conversion period.
+//
+// Scale/offset work like the HX711 library's: units = (raw - offset) / scale. The blocking helpers (tare, getUnits)
+// are for calibration and average the next samples without consuming the ring.
+class StrainReader : public Task<StrainReader>
+{
+    friend class Task<StrainReader>; // Allow base Task to invoke protected run()
+
+public:
+    StrainReader(uint8_t pin_dout, uint8_t pin_sck, const uint8_t task_core);
+
+    // Consumer side (one task only): next sample in arrival order, if any. Samples are dropped if nobody pops them.
+    bool popSample(StrainSample &sample);
+    float toUnits(int32_t raw) const;
+
+    // Whether samples are arriving, waiting up to timeout_ms for the next one if the last was a while ago
+    bool waitReady(uint32_t timeout_ms);
+    // Average of the next times samples; returns false if they didn't arrive in time
+    bool readAverage(float &average, uint8_t times);
+    float getUnits(uint8_t times = 1);
+    void tare(uint8_t times = 10);
+
+    void setScale(float scale = 1.0f);
+    float getScale() const;
+    void setOffset(int32_t offset);
+    int32_t getOffset() const;
+
+    void powerDown();
+    void powerUp();
+    bool isPowered() const;
+
+protected:
+    void run();
+
+private:
+    const uint8_t pin_dout_;
+    const uint8_t pin_sck_;
+
+    portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+    volatile uint32_t ready_us_ = 0;
+    std::atomic<bool> powered_{true};
+    std::atomic<float> scale_{1.0f};
+    std::atomic<int32_t> offset_{0};
+
+    MpscRing<StrainSample, 32> samples_;
+    LatestMailbox<StrainSample> latest_;
+
+    static void IRAM_ATTR onDataReady(void *arg);
+    bool readConversion(int32_t &raw);
+};
@@ -13,14 +13,23 @@ static SerialProtocolProtobuf *singleton_for_packet_serial = 0;
 
 static const uint16_t MIN_STATE_INTERVAL_MILLIS = 1000;
 static const uint16_t PERIODIC_STATE_INTERVAL_MILLIS = 5000;
-
-SerialProtocolProtobuf::SerialProtocolProtobuf(Stream &stream, Configuration *configuration, ConfigCallback config_callback, MotorCalibrationCallback motor_calibration_callback, StrainCalibrationCallback strain_calibration_callback) : SerialProtocol(),
-                                                                                                                                                                                                                                           stream_(stream),
-                                                                                                                                                                                                                                           configuration_(configuration),
-                                                                                                                                                                                                                                           config_callback_(config_callback),
-                                                                                                                                                                                                                                           motor_calibration_callback_(motor_calibration_callback),
-                                                                                                                                                                                                                                           strain_calibration_callback_(strain_calibration_callback),
-                                                                                                                                                                                                                                           packet_serial_()
+// Recording chunks sent per loop() while dumping
+static const uint8_t RECORDING_CHUNKS_PER_LOOP = 4;
+
+SerialProtocolProtobuf::SerialProtocolProtobuf(Stream &stream, Configuration *configuration, ConfigCallback config_callback, DetentPositionsCallback detent_positions_callback, HapticEffectCallback haptic_effect_callback, MotorCalibrationCallback motor_calibration_callback, MotorAutotuneCallback motor_autotune_callback, MotorTimingCallback motor_timing_callback, MotorThermalCallback motor_thermal_callback, SensorRecorderCallback sensor_recorder_callback, SensorRecordingCallback sensor_recording_callback, StrainCalibrationCallback strain_calibration_callback) : SerialProtocol(),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      stream_(stream),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      configuration_(configuration),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      config_callback_(config_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      detent_positions_callback_(detent_positions_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      haptic_effect_callback_(haptic_effect_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      motor_calibration_callback_(motor_calibration_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      motor_autotune_callback_(motor_autotune_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      motor_timing_callback_(motor_timing_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      motor_thermal_callback_(motor_thermal_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      sensor_recorder_callback_(sensor_recorder_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      sensor_recording_callback_(sensor_recording_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      strain_calibration_callback_(strain_calibration_callback),
+                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                      packet_serial_()
 {
     packet_serial_.setStream(&stream);
 
@@ -115,6 +124,66 @@ void SerialProtocolProtobuf::sendStrainCalibState(const uint8_t step)
     sendPbTxBuffer();
 }
 
+void SerialProtocolProtobuf::sendMotorCalibState(const PB_MotorCalibState &state)
+{
+    pb_tx_buffer_ = {};
+    pb_tx_buffer_.which_payload = PB_FromSmartKnob_motor_calib_state_tag;
+    pb_tx_buffer_.payload.motor_calib_state = state;
+
+    sendPbTxBuffer();
+}
+
+void SerialProtocolProtobuf::sendMotorTiming()
+{
+    pb_tx_buffer_ = {};
+    pb_tx_buffer_.which_payload = PB_FromSmartKnob_motor_timing_tag;
+    if (!motor_timing_callback_(pb_tx_buffer_.payload.motor_timing))
+    {
+        LOGW("Motor timing not available, build with SK_MOTOR_TIMING=1");
+        return;
+    }
+
+    sendPbTxBuffer();
+}
+
+void SerialProtocolProtobuf::sendMotorThermal()
+{
+    pb_tx_buffer_ = {};
+    pb_tx_buffer_.which_payload = PB_FromSmartKnob_motor_thermal_tag;
+    if (!motor_thermal_callback_(pb_tx_buffer_.payload.motor_thermal))
+    {
+        LOGW("Motor thermal state not available, build with SK_MOTOR_THERMAL_LIMIT=1");
+        return;
+    }
+
+    sendPbTxBuffer();
+}
+
+void SerialProtocolProtobuf::sendSensorRecording()
+{
+    pb_tx_buffer_ = {};
+    pb_tx_buffer_.which_payload = PB_FromSmartKnob_sensor_recording_tag;
+    PB_SensorRecording &chunk = pb_tx_buffer_.payload.sensor_recording;
+    if (!sensor_recording_callback_(recording_offset_, chunk))
+    {
+        if (recording_offset_ == 0)
+        {
+            LOGW("No sensor recording available, arm and trigger the recorder first (needs SK_RECORDER=1)");
+        }
+        dumping_recording_ = false;
+        return;
+    }
+
+    sendPbTxBuffer();
+
+    recording_offset_ += chunk.samples_count;
+    if (recording_offset_ >= chunk.total)
+    {
+        LOGD("Sent sensor recording, %u samples", chunk.total);
+        dumping_recording_ = false;
+    }
+}
+
 void SerialProtocolProtobuf::loop()
 {
     do
@@ -122,6 +191,11 @@ void SerialProtocolProtobuf::loop()
         packet_serial_.update();
     } while (stream_.available());
 
+    for (uint8_t i = 0; i < RECORDING_CHUNKS_PER_LOOP && dumping_recording_; i++)
+    {
+        sendSensorRecording();
+    }
+
     delay(1);
 }
 
@@ -175,6 +249,22 @@ void SerialProtocolProtobuf::handlePacket(const uint8_t *buffer, size_t size)
         config_callback_(pb_rx_buffer_.payload.smartknob_config);
         break;
     }
+    case PB_ToSmartknob_detent_positions_tag:
+    {
+        if (!detent_positions_callback_(pb_rx_buffer_.payload.detent_positions))
+        {
+            LOGW("Detent positions chunk for '%s' at offset %u was not applied", pb_rx_buffer_.payload.detent_positions.config_id, pb_rx_buffer_.payload.detent_positions.offset);
+        }
+        break;
+    }
+    case PB_ToSmartknob_haptic_effect_tag:
+    {
+        if (!haptic_effect_callback_(pb_rx_buffer_.payload.haptic_effect))
+        {
+            LOGW("Haptic effect was not applied (waveform %u, %u samples)", pb_rx_buffer_.payload.haptic_effect.waveform, pb_rx_buffer_.payload.haptic_effect.samples.size);
+        }
+        break;
+    }
     case PB_ToSmartknob_strain_calibration_tag:
     {
         strain_calibration_callback_(pb_rx_buffer_.payload.strain_calibration.calibration_weight);
@@ -200,6 +290,39 @@ void SerialProtocolProtobuf::handlePacket(const uint8_t *buffer, size_t size)
             LOGD("Motor Calibrate");
             motor_calibration_callback_();
             break;
+        case PB_SmartKnobCommand_MOTOR_AUTOTUNE:
+            LOGD("Motor Autotune");
+            motor_autotune_callback_();
+            break;
+        case PB_SmartKnobCommand_GET_MOTOR_TIMING:
+            LOGD("Get Motor Timing");
+            sendMotorTiming();
+            break;
+        case PB_SmartKnobCommand_GET_MOTOR_THERMAL:
+            LOGD("Get Motor Thermal");
+            sendMotorThermal();
+            break;
+        case PB_SmartKnobCommand_RECORDER_ARM:
+            LOGD("Recorder Arm");
+            // Re-arming overwrites the recording, don't keep sending it
+            dumping_recording_ = false;
+            if (!sensor_recorder_callback_(PB_SmartKnobCommand_RECORDER_ARM))
+            {
+                LOGW("Sensor recorder not available, build with SK_RECORDER=1");
+            }
+            break;
+        case PB_SmartKnobCommand_RECORDER_TRIGGER:
+            LOGD("Recorder Trigger");
+            if (!sensor_recorder_callback_(PB_SmartKnobCommand_RECORDER_TRIGGER))
+            {
+                LOGW("Sensor recorder not available, build with SK_RECORDER=1");
+            }
+            break;
+        case PB_SmartKnobCommand_RECORDER_DUMP:
+            LOGD("Recorder Dump");
+            dumping_recording_ = true;
+            recording_offset_ = 0;
+            break;
         // case PB_SmartKnobCommand_STRAIN_CALIBRATE:
         //     LOGD("Strain Calibrate");
         //     strain_calibration_callback_();
@@ -12,12 +12,16 @@
 class SerialProtocolProtobuf : public SerialProtocol
 {
 public:
-    SerialProtocolProtobuf(Stream &stream, Configuration *configuration, ConfigCallback config_callback, MotorCalibrationCallback motor_calibration_callback, FactoryStrainCalibrationCallback factory_strain_calibration_callback);
+    SerialProtocolProtobuf(Stream &stream, Configuration *configuration, ConfigCallback config_callback, DetentPositionsCallback detent_positions_callback, HapticEffectCallback haptic_effect_callback, MotorCalibrationCallback motor_calibration_callback, MotorAutotuneCallback motor_autotune_callback, MotorTimingCallback motor_timing_callback, MotorThermalCallback motor_thermal_callback, SensorRecorderCallback sensor_recorder_callback, SensorRecordingCallback sensor_recording_callback, FactoryStrainCalibrationCallback factory_strain_calibration_callback);
     ~SerialProtocolProtobuf() {};
     void log(const char *msg) override;
     void log(const PB_LogLevel log_level, bool isVerbose_, const char *origin, const char *msg) override;
     void sendInitialInfo();
     void sendStrainCalibState(const uint8_t step);
+    void sendMotorTiming();
+    void sendMotorThermal();
+    void sendSensorRecording();
+    void sendMotorCalibState(const PB_MotorCalibState &state);
     void loop() override;
     void handleState(const PB_SmartKnobState &state) override;
 
@@ -25,7 +29,14 @@ private:
     Stream &stream_;
     Configuration *configuration_;
     ConfigCallback config_callback_;
+    DetentPositionsCallback detent_positions_callback_;
+    HapticEffectCallback haptic_effect_callback_;
     MotorCalibrationCallback motor_calibration_callback_;
+    MotorAutotuneCallback motor_autotune_callback_;
+    MotorTimingCallback motor_timing_callback_;
+    MotorThermalCallback motor_thermal_callback_;
+    SensorRecorderCallback sensor_recorder_callback_;
+    SensorRecordingCallback sensor_recording_callback_;
     StrainCalibrationCallback strain_calibration_callback_;
 
     PB_FromSmartKnob pb_tx_buffer_;
@@ -43,6 +54,10 @@ private:
 
     bool state_requested_;
 
+    // A recording dump in progress, sent a few chunks per loop so incoming packets still get handled
+    bool dumping_recording_ = false;
+    uint32_t recording_offset_ = 0;
+
     void sendPbTxBuffer();
     void handlePacket(const uint8_t *buffer, size_t size);
     void ack(uint32_t nonce);
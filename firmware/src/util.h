@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include "Arduino.h"
 #include "lvgl.h"
+#include "math_util.h"
 
 // ? MOVE STYLE STUFF TO SEPERATE FILE
 
@@ -31,37 +32,4 @@ LV_STYLE_CONST_INIT(SK_X20_ICON_STYLE, x20_icon_style_props);
 
 lv_obj_t *lvDrawCircle(const uint8_t dia, lv_obj_t *parent = NULL);
 
-template <typename T>
-T CLAMP(const T &value, const T &low, const T &high)
-{
-    return value < low ? low : (value > high ? high : value);
-}
-
-#define COUNT_OF(A) (sizeof(A) / sizeof(A[0]))
-
 float lerp(const float value, const float inMin, const float inMax, const float min, const float max);
-
-template <typename T>
-int sgn(T val)
-{
-    return (T(0) < val) - (val < T(0));
-}
-
-// source: https://github.com/careyi3/MovingAverage/blob/master/src/MovingAverage.cpp
-class MovingAverage
-{
-public:
-    MovingAverage(int filterLength);
-    float addSample(float newValue);
-    float getValue();
-    void dumpFilter();
-
-private:
-    float *filterPointer;
-    int filterLength;
-    float lastValue;
-
-    void initFilter();
-    void shiftFilter(float nextValue);
-    void computeAverage();
-};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <unity.h>
+
+// Runs body(i) for i in [0, iterations) and reports the mean time per call. Host timings only compare implementations
+// against each other; they say nothing about absolute cost on the ESP32.
+template <typename F>
+double benchmark(const char *name, uint32_t iterations, F body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        body(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %.1f ns/call", name, ns);
+    TEST_MESSAGE(message);
+    return ns;
+}
@@ -0,0 +1,155 @@
+#include <math.h>
+#include <unity.h>
+
+#include "motor_foc/angle_tracker.h"
+#include "../benchmark.h"
+
+// The MT6701 default, see SK_MT6701_TRACKER_HZ
+static const float BANDWIDTH_HZ = 300;
+// FOC timer rate, and the rate calibration, autotune, the legacy loop and idle mode sample at
+static const float FAST_DT = 0.0002;
+static const float SLOW_DT = 0.001;
+
+void setUp() {}
+void tearDown() {}
+
+static float wrap(float angle)
+{
+    angle = fmodf(angle, 2 * M_PI);
+    return angle < 0 ? angle + 2 * M_PI : angle;
+}
+
+static float angleError(float a, float b)
+{
+    float d = wrap(a - b);
+    return d > M_PI ? d - 2 * M_PI : d;
+}
+
+// Track a constant velocity from rest for a second, return the worst angle error over the last half
+static float trackConstantVelocity(float dt, float velocity, float jitter = 0)
+{
+    AngleTracker tracker;
+    tracker.setBandwidth(BANDWIDTH_HZ);
+    float t = 0;
+    float worst = 0;
+    for (uint32_t i = 0; t < 1; i++)
+    {
+        // Deterministic +-jitter around dt
+        float step = dt * (1 + jitter * (((i * 7919) % 201) / 100.0f - 1));
+        t += step;
+        tracker.update(wrap(1 + velocity * t), step);
+        TEST_ASSERT_TRUE(isfinite(tracker.velocity()));
+        if (t > 0.5)
+        {
+            worst = fmaxf(worst, fabsf(angleError(tracker.angle(), 1 + velocity * t)));
+        }
+    }
+    TEST_ASSERT_FLOAT_WITHIN(fabsf(velocity) * 0.01f, velocity, tracker.velocity());
+    return worst;
+}
+
+// Step the measured angle by 0.5 rad and return the largest excursion from the new angle
+static float stepResponse(float dt, float &final_error)
+{
+    AngleTracker tracker;
+    tracker.setBandwidth(BANDWIDTH_HZ);
+    tracker.update(1, dt);
+    tracker.update(1, dt);
+    float worst = 0;
+    for (int i = 0; i < (int)(0.1f / dt); i++)
+    {
+        tracker.update(1.5, dt);
+        worst = fmaxf(worst, fabsf(angleError(tracker.angle(), 1.5)));
+    }
+    final_error = fabsf(angleError(tracker.angle(), 1.5));
+    return worst;
+}
+
+static void assertStableStep(float dt)
+{
+    float final_error;
+    float worst = stepResponse(dt, final_error);
+    // Critically damped: no ringing beyond the initial error, and settled well within 100ms
+    TEST_ASSERT_TRUE(worst <= 0.5f + 1e-4f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, final_error);
+}
+
+void test_tracks_constant_velocity_fast_updates()
+{
+    TEST_ASSERT_TRUE(trackConstantVelocity(FAST_DT, 20) < 1e-3f);
+}
+
+void test_tracks_constant_velocity_slow_updates()
+{
+    TEST_ASSERT_TRUE(trackConstantVelocity(SLOW_DT, 20) < 1e-3f);
+}
+
+void test_tracks_negative_velocity_across_zero()
+{
+    TEST_ASSERT_TRUE(trackConstantVelocity(FAST_DT, -30) < 1e-3f);
+    TEST_ASSERT_TRUE(trackConstantVelocity(SLOW_DT, -30) < 1e-3f);
+}
+
+void test_tracks_with_jittery_updates()
+{
+    TEST_ASSERT_TRUE(trackConstantVelocity(SLOW_DT, 20, 0.1) < 2e-3f);
+}
+
+void test_step_is_stable_fast_updates()
+{
+    assertStableStep(FAST_DT);
+}
+
+void test_step_is_stable_slow_updates()
+{
+    assertStableStep(SLOW_DT);
+}
+
+void test_step_is_stable_at_any_interval()
+{
+    // Intervals where a forward Euler step of the same gains diverges
+    assertStableStep(0.0005);
+    assertStableStep(0.0011);
+    assertStableStep(0.005);
+}
+
+void test_long_gap_restarts_tracking()
+{
+    AngleTracker tracker;
+    tracker.setBandwidth(BANDWIDTH_HZ);
+    tracker.update(1, FAST_DT);
+    tracker.update(1, FAST_DT);
+    tracker.update(3, 0.5);
+    TEST_ASSERT_EQUAL_FLOAT(3, tracker.angle());
+    TEST_ASSERT_EQUAL_FLOAT(0, tracker.velocity());
+}
+
+void test_benchmark_update()
+{
+    AngleTracker tracker;
+    tracker.setBandwidth(BANDWIDTH_HZ);
+    volatile float sink = 0;
+    benchmark("AngleTracker::update", 1000000, [&](uint32_t i)
+              {
+                  tracker.update(wrap(i * 0.004f), FAST_DT);
+                  sink = sink + tracker.angle(); });
+    benchmark("AngleTracker::update, jittery dt", 1000000, [&](uint32_t i)
+              {
+                  tracker.update(wrap(i * 0.004f), i % 2 ? FAST_DT * 1.05f : FAST_DT * 0.95f);
+                  sink = sink + tracker.angle(); });
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tracks_constant_velocity_fast_updates);
+    RUN_TEST(test_tracks_constant_velocity_slow_updates);
+    RUN_TEST(test_tracks_negative_velocity_across_zero);
+    RUN_TEST(test_tracks_with_jittery_updates);
+    RUN_TEST(test_step_is_stable_fast_updates);
+    RUN_TEST(test_step_is_stable_slow_updates);
+    RUN_TEST(test_step_is_stable_at_any_interval);
+    RUN_TEST(test_long_gap_restarts_tracking);
+    RUN_TEST(test_benchmark_update);
+    return UNITY_END();
+}
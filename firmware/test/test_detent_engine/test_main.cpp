@@ -0,0 +1,319 @@
+#include <math.h>
+#include <unity.h>
+
+#include "motor_foc/detent_engine.h"
+#include "../benchmark.h"
+
+static const float WIDTH = 0.2;
+// Fast enough that the torque ramp never limits a single step in these tests
+static const float TORQUE_RAMP = 1e6;
+static const uint32_t TICK_US = 1000;
+
+static PB_SmartKnobConfig boundedConfig()
+{
+    PB_SmartKnobConfig config = {};
+    config.min_position = 0;
+    config.max_position = 10;
+    config.position_width_radians = WIDTH;
+    config.detent_strength_unit = 1;
+    config.endstop_strength_unit = 1;
+    config.snap_point = 1.1;
+    return config;
+}
+
+// Knob rotor driven by the engine's torque (motor voltage) through a simple inertia plus viscous friction model, in
+// voltage units: roughly a gimbal motor (~5 mNm/V) with a knob of ~1e-5 kg m^2 on it
+struct Rotor
+{
+    float inertia = 2e-3;
+    float friction = 2e-3;
+    float angle = 0;
+    float velocity = 0;
+
+    void step(float torque, float dt)
+    {
+        velocity += (torque - friction * velocity) / inertia * dt;
+        angle += velocity * dt;
+    }
+};
+
+struct ClosedLoopResult
+{
+    DetentOutput out;
+    float max_abs_velocity;
+    // Position changes over the last half of the run, after the knob should have settled
+    uint32_t late_position_changes;
+};
+
+// Release the rotor at angle (at rest) and let the engine's torque move it for seconds, ticking the engine at
+// TICK_US like the detent stage
+static ClosedLoopResult runClosedLoop(DetentEngine &engine, float angle, float seconds)
+{
+    Rotor rotor;
+    rotor.angle = angle;
+    ClosedLoopResult result = {};
+    const float dt = TICK_US * 1e-6f;
+    const uint32_t ticks = seconds / dt;
+    for (uint32_t i = 1; i <= ticks; i++)
+    {
+        DetentOutput out = engine.update(rotor.angle, rotor.velocity, i * TICK_US);
+        if (i > ticks / 2 && out.position != result.out.position)
+        {
+            result.late_position_changes++;
+        }
+        result.out = out;
+        rotor.step(out.torque, dt);
+        result.max_abs_velocity = fmaxf(result.max_abs_velocity, fabsf(rotor.velocity));
+    }
+    return result;
+}
+
+static DetentEngine engineAt(const PB_SmartKnobConfig &config, float angle = 0)
+{
+    DetentEngine engine(TORQUE_RAMP);
+    engine.reset(angle);
+    TEST_ASSERT_NULL(DetentEngine::validate(config));
+    engine.setConfig(config, angle);
+    return engine;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_validate_rejects_unstable_snap_point()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.snap_point = 0.4;
+    TEST_ASSERT_NOT_NULL(DetentEngine::validate(config));
+}
+
+void test_snaps_past_snap_point()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+
+    // Positions increase with decreasing angle; just short of the snap point stays put
+    DetentOutput out = engine.update(-0.21, 0, TICK_US);
+    TEST_ASSERT_EQUAL_INT32(0, out.position);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 1.05, out.sub_position_unit);
+
+    out = engine.update(-0.23, 0, 2 * TICK_US);
+    TEST_ASSERT_EQUAL_INT32(1, out.position);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.15, out.sub_position_unit);
+
+    // And back
+    out = engine.update(0.03, 0, 3 * TICK_US);
+    TEST_ASSERT_EQUAL_INT32(0, out.position);
+}
+
+void test_snaps_one_detent_per_tick()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+    DetentOutput out = {};
+    for (uint32_t i = 1; i <= 5; i++)
+    {
+        out = engine.update(-1.05, 0, i * TICK_US);
+        TEST_ASSERT_EQUAL_INT32(i, out.position);
+    }
+}
+
+void test_stops_at_bounds_and_pushes_back()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+
+    // Already at min_position, turning further the "decrease" way must not go below it
+    DetentOutput out = engine.update(0.3, 0, TICK_US);
+    TEST_ASSERT_EQUAL_INT32(0, out.position);
+    TEST_ASSERT_TRUE_MESSAGE(out.torque < 0, "endstop should push back towards the range");
+
+    // Past max_position
+    PB_SmartKnobConfig config = boundedConfig();
+    config.position = 10;
+    config.position_nonce = 1;
+    DetentEngine at_max = engineAt(config);
+    out = at_max.update(-0.3, 0, TICK_US);
+    TEST_ASSERT_EQUAL_INT32(10, out.position);
+    TEST_ASSERT_TRUE_MESSAGE(out.torque > 0, "endstop should push back towards the range");
+}
+
+void test_unbounded_when_max_below_min()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.min_position = 0;
+    config.max_position = -1;
+    DetentEngine engine = engineAt(config);
+
+    DetentOutput out = engine.update(0.23, 0, TICK_US);
+    TEST_ASSERT_EQUAL_INT32(-1, out.position);
+}
+
+void test_recenters_when_idle_near_center()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+
+    // Resting a little off center for 10 seconds slowly moves the center under the knob
+    DetentOutput out = {};
+    for (uint32_t i = 1; i <= 10000; i++)
+    {
+        out = engine.update(0.02, 0, i * TICK_US);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, out.position);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0, out.sub_position_unit);
+}
+
+void test_does_not_recenter_far_from_center()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+
+    // 0.1 rad is beyond the re-centering window (5 degrees) but short of the snap point
+    DetentOutput out = {};
+    for (uint32_t i = 1; i <= 10000; i++)
+    {
+        out = engine.update(0.1, 0, i * TICK_US);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, -0.5, out.sub_position_unit);
+}
+
+void test_does_not_recenter_while_moving()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+
+    DetentOutput out = {};
+    for (uint32_t i = 1; i <= 10000; i++)
+    {
+        out = engine.update(0.02, 0.5, i * TICK_US);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, -0.1, out.sub_position_unit);
+}
+
+// Detent torque in the middle of the range, away from the endstops
+static float torqueAt(PB_SmartKnobConfig config, float angle, float velocity)
+{
+    config.position = 5;
+    DetentEngine engine = engineAt(config);
+    return engine.update(angle, velocity, TICK_US).torque;
+}
+
+void test_damping_opposes_velocity()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    float at_rest = torqueAt(config, 0.05, 0);
+    TEST_ASSERT_TRUE_MESSAGE(at_rest < 0, "detent should pull back to the center");
+
+    float moving_away = torqueAt(config, 0.05, 1);
+    float moving_back = torqueAt(config, 0.05, -1);
+    TEST_ASSERT_TRUE(moving_away < at_rest);
+    TEST_ASSERT_TRUE(moving_back > at_rest);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, at_rest - moving_away, moving_back - at_rest);
+}
+
+void test_no_torque_or_damping_in_dead_zone()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    TEST_ASSERT_EQUAL_FLOAT(0, torqueAt(config, 0.005, 0));
+    TEST_ASSERT_EQUAL_FLOAT(0, torqueAt(config, 0.005, 1));
+}
+
+void test_no_damping_with_magnetic_detents()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.detent_positions_count = 1;
+    config.detent_positions[0] = 5;
+    TEST_ASSERT_EQUAL_FLOAT(torqueAt(config, 0.05, 0), torqueAt(config, 0.05, 1));
+}
+
+void test_no_torque_at_runaway_velocity()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0, torqueAt(boundedConfig(), 0.05, 100));
+}
+
+void test_closed_loop_settles_back_into_detent()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.position = 5;
+    DetentEngine engine = engineAt(config);
+
+    // Released 0.6 detents towards position 6, short of the snap point
+    ClosedLoopResult result = runClosedLoop(engine, -0.6 * WIDTH, 3);
+    TEST_ASSERT_EQUAL_INT32(5, result.out.position);
+    TEST_ASSERT_EQUAL_INT32(0, result.late_position_changes);
+    // At rest inside the dead zone (1 degree) of the detent center
+    TEST_ASSERT_FLOAT_WITHIN(0.02, 0, engine.subPositionUnit() * WIDTH);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, result.out.torque);
+}
+
+void test_closed_loop_settles_into_next_detent_past_snap_point()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.position = 5;
+    config.snap_point = 0.55;
+    DetentEngine engine = engineAt(config);
+
+    ClosedLoopResult result = runClosedLoop(engine, -0.7 * WIDTH, 3);
+    TEST_ASSERT_EQUAL_INT32(6, result.out.position);
+    TEST_ASSERT_EQUAL_INT32(0, result.late_position_changes);
+    TEST_ASSERT_FLOAT_WITHIN(0.02, 0, engine.subPositionUnit() * WIDTH);
+}
+
+void test_closed_loop_stays_at_bounds()
+{
+    PB_SmartKnobConfig config = boundedConfig();
+    config.position = 10;
+    DetentEngine engine = engineAt(config);
+
+    // Released a detent past max_position: the endstop pushes the rotor back without running away. (The endstop is an
+    // undamped spring, so from much further out the rotor springs back over the next snap point.)
+    ClosedLoopResult result = runClosedLoop(engine, -WIDTH, 3);
+    TEST_ASSERT_EQUAL_INT32(10, result.out.position);
+    TEST_ASSERT_EQUAL_INT32(0, result.late_position_changes);
+    TEST_ASSERT_FLOAT_WITHIN(0.02, 0, engine.subPositionUnit() * WIDTH);
+    TEST_ASSERT_TRUE_MESSAGE(result.max_abs_velocity < 60, "rotor ran away");
+
+    // Same at min_position
+    config.position = 0;
+    config.position_nonce = 1;
+    DetentEngine at_min = engineAt(config);
+    result = runClosedLoop(at_min, WIDTH, 3);
+    TEST_ASSERT_EQUAL_INT32(0, result.out.position);
+    TEST_ASSERT_EQUAL_INT32(0, result.late_position_changes);
+    TEST_ASSERT_FLOAT_WITHIN(0.02, 0, at_min.subPositionUnit() * WIDTH);
+    TEST_ASSERT_TRUE_MESSAGE(result.max_abs_velocity < 60, "rotor ran away");
+}
+
+void test_benchmark_update()
+{
+    DetentEngine engine = engineAt(boundedConfig());
+    Rotor rotor;
+    const float dt = 200e-6f;
+    volatile float sink = 0;
+    benchmark("DetentEngine::update", 1000000, [&](uint32_t i)
+              {
+                  // The rotor follows the detent torque plus a slowly alternating hand torque, which drags it back and
+                  // forth across several detents
+                  float hand = (i / 20000) % 2 == 0 ? -1.5f : 1.5f;
+                  DetentOutput out = engine.update(rotor.angle, rotor.velocity, i * 200);
+                  rotor.step(out.torque + hand, dt);
+                  sink = sink + out.torque; });
+    TEST_ASSERT_TRUE_MESSAGE(fabsf(rotor.velocity) < 60, "rotor ran away");
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_validate_rejects_unstable_snap_point);
+    RUN_TEST(test_snaps_past_snap_point);
+    RUN_TEST(test_snaps_one_detent_per_tick);
+    RUN_TEST(test_stops_at_bounds_and_pushes_back);
+    RUN_TEST(test_unbounded_when_max_below_min);
+    RUN_TEST(test_recenters_when_idle_near_center);
+    RUN_TEST(test_does_not_recenter_far_from_center);
+    RUN_TEST(test_does_not_recenter_while_moving);
+    RUN_TEST(test_damping_opposes_velocity);
+    RUN_TEST(test_no_torque_or_damping_in_dead_zone);
+    RUN_TEST(test_no_damping_with_magnetic_detents);
+    RUN_TEST(test_no_torque_at_runaway_velocity);
+    RUN_TEST(test_closed_loop_settles_back_into_detent);
+    RUN_TEST(test_closed_loop_settles_into_next_detent_past_snap_point);
+    RUN_TEST(test_closed_loop_stays_at_bounds);
+    RUN_TEST(test_benchmark_update);
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include <math.h>
+#include <unity.h>
+
+#include "motor_foc/fast_math.h"
+#include "../benchmark.h"
+
+static const float SIN_TOLERANCE = 8e-5;
+static const float ATAN2_TOLERANCE = 1.2e-5;
+
+void setUp() {}
+void tearDown() {}
+
+static float angleDifference(float a, float b)
+{
+    float d = fmodf(a - b, 2 * M_PI);
+    if (d > M_PI)
+    {
+        d -= 2 * M_PI;
+    }
+    else if (d < -M_PI)
+    {
+        d += 2 * M_PI;
+    }
+    return d;
+}
+
+void test_sin_cos_accuracy()
+{
+    float max_error = 0;
+    for (int i = -200000; i <= 200000; i++)
+    {
+        float angle = i * 1e-4f;
+        float s, c;
+        fastSinCos(angle, &s, &c);
+        max_error = fmaxf(max_error, fabsf(s - sinf(angle)));
+        max_error = fmaxf(max_error, fabsf(c - cosf(angle)));
+        TEST_ASSERT_EQUAL_FLOAT(s, fastSin(angle));
+        TEST_ASSERT_EQUAL_FLOAT(c, fastCos(angle));
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "fastSinCos max error %.2e", max_error);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(max_error < SIN_TOLERANCE);
+}
+
+void test_atan2_accuracy()
+{
+    const float radii[] = {1e-3, 1, 1000};
+    float max_error = 0;
+    for (float radius : radii)
+    {
+        for (int i = 0; i < 100000; i++)
+        {
+            float angle = -M_PI + i * (2 * M_PI / 100000);
+            float y = radius * sinf(angle);
+            float x = radius * cosf(angle);
+            max_error = fmaxf(max_error, fabsf(angleDifference(fastAtan2(y, x), atan2f(y, x))));
+        }
+    }
+    char message[64];
+    snprintf(message, sizeof(message), "fastAtan2 max error %.2e", max_error);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(max_error < ATAN2_TOLERANCE);
+}
+
+void test_atan2_axes_and_signed_zero()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0, fastAtan2(0, 0));
+    TEST_ASSERT_FLOAT_WITHIN(ATAN2_TOLERANCE, M_PI / 2, fastAtan2(1, 0));
+    TEST_ASSERT_FLOAT_WITHIN(ATAN2_TOLERANCE, -M_PI / 2, fastAtan2(-1, 0));
+    TEST_ASSERT_FLOAT_WITHIN(ATAN2_TOLERANCE, M_PI, fastAtan2(0.0f, -1));
+    // Same as atan2f: the sign of a zero y picks the side of the branch cut
+    TEST_ASSERT_FLOAT_WITHIN(ATAN2_TOLERANCE, atan2f(-0.0f, -1), fastAtan2(-0.0f, -1));
+    TEST_ASSERT_TRUE(signbit(fastAtan2(-0.0f, 1)));
+    TEST_ASSERT_FALSE(signbit(fastAtan2(0.0f, 1)));
+}
+
+void test_benchmark_trig()
+{
+    volatile float sink = 0;
+    const uint32_t iterations = 1000000;
+
+    float fast_sin_cos = benchmark("fastSinCos", iterations, [&](uint32_t i)
+                                   {
+                                       float s, c;
+                                       fastSinCos(i * 1e-4f, &s, &c);
+                                       sink = sink + s + c; });
+    float libm_sin_cos = benchmark("sinf + cosf", iterations, [&](uint32_t i)
+                                   {
+                                       float angle = i * 1e-4f;
+                                       sink = sink + sinf(angle) + cosf(angle); });
+
+    float fast_atan2 = benchmark("fastAtan2", iterations, [&](uint32_t i)
+                                 { sink = sink + fastAtan2((float)(i & 0x3ff) - 512, (float)((i >> 10) & 0x3ff) - 512); });
+    float libm_atan2 = benchmark("atan2f", iterations, [&](uint32_t i)
+                                 { sink = sink + atan2f((float)(i & 0x3ff) - 512, (float)((i >> 10) & 0x3ff) - 512); });
+
+    char message[96];
+    snprintf(message, sizeof(message), "speedup vs libm: sin/cos %.1fx, atan2 %.1fx", libm_sin_cos / fast_sin_cos, libm_atan2 / fast_atan2);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sin_cos_accuracy);
+    RUN_TEST(test_atan2_accuracy);
+    RUN_TEST(test_atan2_axes_and_signed_zero);
+    RUN_TEST(test_benchmark_trig);
+    return UNITY_END();
+}
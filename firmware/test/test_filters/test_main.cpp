@@ -0,0 +1,175 @@
+#include <math.h>
+#include <unity.h>
+
+#include "filters.h"
+#include "../benchmark.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_moving_average_partial_window()
+{
+    MovingAverage<4> filter;
+    TEST_ASSERT_EQUAL_FLOAT(2, filter.addSample(2));
+    TEST_ASSERT_EQUAL_FLOAT(3, filter.addSample(4));
+    TEST_ASSERT_EQUAL_FLOAT(4, filter.addSample(6));
+    TEST_ASSERT_EQUAL_FLOAT(5, filter.addSample(8));
+    // Window full, the oldest sample drops out
+    TEST_ASSERT_EQUAL_FLOAT(7, filter.addSample(10));
+    TEST_ASSERT_EQUAL_FLOAT(7, filter.getValue());
+}
+
+void test_moving_average_resum_discards_rounding()
+{
+    MovingAverage<4> filter;
+    for (int i = 0; i < 4; i++)
+    {
+        filter.addSample(1e8);
+    }
+    // A running sum alone would be left with the rounding error of 1e8 + 1 - 1e8, the re-sum after a full window
+    // makes it exact again
+    for (int i = 0; i < 4; i++)
+    {
+        filter.addSample(1);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(1, filter.getValue());
+}
+
+void test_moving_average_fill()
+{
+    MovingAverage<4> filter;
+    filter.addSample(100);
+    filter.fill(5);
+    TEST_ASSERT_EQUAL_FLOAT(5, filter.getValue());
+    // The whole window counts, no partial average
+    TEST_ASSERT_EQUAL_FLOAT(6, filter.addSample(9));
+}
+
+void test_moving_average_reset()
+{
+    MovingAverage<4> filter;
+    filter.fill(5);
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(0, filter.getValue());
+    TEST_ASSERT_EQUAL_FLOAT(3, filter.addSample(3));
+}
+
+void test_median_odd_count()
+{
+    MedianFilter<3> filter;
+    filter.addSample(0);
+    filter.addSample(0);
+    // A single spike is rejected
+    TEST_ASSERT_EQUAL_FLOAT(0, filter.addSample(100));
+    TEST_ASSERT_EQUAL_FLOAT(100, filter.addSample(100));
+}
+
+void test_median_even_count()
+{
+    MedianFilter<5> filter;
+    TEST_ASSERT_EQUAL_FLOAT(1, filter.addSample(1));
+    // Two samples: mean of the middle pair
+    TEST_ASSERT_EQUAL_FLOAT(5.5, filter.addSample(10));
+    TEST_ASSERT_EQUAL_FLOAT(3, filter.addSample(3));
+    TEST_ASSERT_EQUAL_FLOAT(5, filter.addSample(7));
+}
+
+void test_ewma_alpha_for()
+{
+    // At a cutoff of 1 / (2 PI dt), the time constant equals dt
+    float dt = 0.001;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.5, Ewma::alphaFor(1 / (2 * M_PI * dt), dt));
+    // Well below the sample rate, alpha approaches 2 PI f dt
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 2 * M_PI * 1 * dt, Ewma::alphaFor(1, dt));
+    // A higher cutoff or a longer interval weighs new samples more
+    TEST_ASSERT_TRUE(Ewma::alphaFor(10, dt) > Ewma::alphaFor(1, dt));
+    TEST_ASSERT_TRUE(Ewma::alphaFor(1, 2 * dt) > Ewma::alphaFor(1, dt));
+}
+
+void test_ewma_primes_with_first_sample()
+{
+    Ewma filter(0.1);
+    TEST_ASSERT_EQUAL_FLOAT(10, filter.addSample(10));
+    TEST_ASSERT_EQUAL_FLOAT(9, filter.addSample(0));
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(4, filter.addSample(4));
+}
+
+void test_one_euro_primes_with_first_sample()
+{
+    OneEuroFilter filter(1, 0.1);
+    TEST_ASSERT_EQUAL_FLOAT(42, filter.addSample(42, 0.01));
+    TEST_ASSERT_EQUAL_FLOAT(42, filter.addSample(42, 0.01));
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(-3, filter.addSample(-3, 0.01));
+}
+
+void test_one_euro_ignores_non_positive_dt()
+{
+    OneEuroFilter filter(1, 0.1);
+    filter.addSample(0, 0.01);
+    float value = filter.addSample(10, 0.01);
+    TEST_ASSERT_EQUAL_FLOAT(value, filter.addSample(1000, 0));
+    TEST_ASSERT_EQUAL_FLOAT(value, filter.addSample(1000, -0.01));
+    TEST_ASSERT_TRUE(isfinite(filter.getValue()));
+}
+
+void test_one_euro_opens_up_for_fast_changes()
+{
+    // Same step, one filter with beta = 0 stays at min_cutoff, the other raises its cutoff with the rate of change
+    OneEuroFilter fixed(1, 0);
+    OneEuroFilter adaptive(1, 1);
+    fixed.addSample(0, 0.01);
+    adaptive.addSample(0, 0.01);
+    for (int i = 0; i < 5; i++)
+    {
+        fixed.addSample(10, 0.01);
+        adaptive.addSample(10, 0.01);
+    }
+    TEST_ASSERT_TRUE(adaptive.getValue() > fixed.getValue());
+    TEST_ASSERT_TRUE(adaptive.getValue() < 10);
+}
+
+void test_benchmark_filters()
+{
+    volatile float sink = 0;
+    const uint32_t iterations = 1000000;
+
+    MovingAverage<10> moving_average;
+    benchmark("MovingAverage<10>::addSample", iterations, [&](uint32_t i)
+              { sink = sink + moving_average.addSample(i & 0xff); });
+
+    Ewma ewma(0.1);
+    benchmark("Ewma::addSample", iterations, [&](uint32_t i)
+              { sink = sink + ewma.addSample(i & 0xff); });
+
+    MedianFilter<3> median3;
+    benchmark("MedianFilter<3>::addSample", iterations, [&](uint32_t i)
+              { sink = sink + median3.addSample(i & 0xff); });
+
+    MedianFilter<9> median9;
+    benchmark("MedianFilter<9>::addSample", iterations, [&](uint32_t i)
+              { sink = sink + median9.addSample((i * 37) & 0xff); });
+
+    OneEuroFilter one_euro(3, 0.02, 5);
+    benchmark("OneEuroFilter::addSample", iterations, [&](uint32_t i)
+              { sink = sink + one_euro.addSample(i & 0xff, 0.0125); });
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_average_partial_window);
+    RUN_TEST(test_moving_average_resum_discards_rounding);
+    RUN_TEST(test_moving_average_fill);
+    RUN_TEST(test_moving_average_reset);
+    RUN_TEST(test_median_odd_count);
+    RUN_TEST(test_median_even_count);
+    RUN_TEST(test_ewma_alpha_for);
+    RUN_TEST(test_ewma_primes_with_first_sample);
+    RUN_TEST(test_one_euro_primes_with_first_sample);
+    RUN_TEST(test_one_euro_ignores_non_positive_dt);
+    RUN_TEST(test_one_euro_opens_up_for_fast_changes);
+    RUN_TEST(test_benchmark_filters);
+    return UNITY_END();
+}
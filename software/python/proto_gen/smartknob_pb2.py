@@ -26,7 +26,7 @@ import nanopb_pb2 as nanopb__pb2
 import settings_pb2 as settings__pb2
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0fsmartknob.proto\x12\x02PB\x1a\x0cnanopb.proto\x1a\x0esettings.proto\"\x9a\x02\n\rFromSmartKnob\x12\x1f\n\x10protocol_version\x18\x01 \x01(\rB\x05\x92?\x02\x38\x08\x12\x18\n\x04knob\x18\x03 \x01(\x0b\x32\x08.PB.KnobH\x00\x12\x16\n\x03\x61\x63k\x18\x04 \x01(\x0b\x32\x07.PB.AckH\x00\x12\x16\n\x03log\x18\x05 \x01(\x0b\x32\x07.PB.LogH\x00\x12-\n\x0fsmartknob_state\x18\x06 \x01(\x0b\x32\x12.PB.SmartKnobStateH\x00\x12\x30\n\x11motor_calib_state\x18\x07 \x01(\x0b\x32\x13.PB.MotorCalibStateH\x00\x12\x32\n\x12strain_calib_state\x18\x08 \x01(\x0b\x32\x14.PB.StrainCalibStateH\x00\x42\t\n\x07payload\"\xb4\x02\n\x0bToSmartknob\x12\x1f\n\x10protocol_version\x18\x01 \x01(\rB\x05\x92?\x02\x38\x08\x12\r\n\x05nonce\x18\x02 \x01(\r\x12)\n\rrequest_state\x18\x03 \x01(\x0b\x32\x10.PB.RequestStateH\x00\x12/\n\x10smartknob_config\x18\x04 \x01(\x0b\x32\x13.PB.SmartKnobConfigH\x00\x12\x31\n\x11smartknob_command\x18\x05 \x01(\x0e\x32\x14.PB.SmartKnobCommandH\x00\x12\x33\n\x12strain_calibration\x18\x06 \x01(\x0b\x32\x15.PB.StrainCalibrationH\x00\x12&\n\x08settings\x18\x07 \x01(\x0b\x32\x12.SETTINGS.SettingsH\x00\x42\t\n\x07payload\"\x9b\x01\n\x04Knob\x12\x1a\n\x0bmac_address\x18\x01 \x01(\tB\x05\x92?\x02p2\x12\x19\n\nip_address\x18\x02 \x01(\tB\x05\x92?\x02p2\x12\x36\n\x11persistent_config\x18\x03 \x01(\x0b\x32\x1b.PB.PersistentConfiguration\x12$\n\x08settings\x18\x04 \x01(\x0b\x32\x12.SETTINGS.Settings\"%\n\x0fMotorCalibState\x12\x12\n\ncalibrated\x18\x01 \x01(\x08\"6\n\x10StrainCalibState\x12\x0c\n\x04step\x18\x01 \x01(\r\x12\x14\n\x0cstrain_scale\x18\x02 \x01(\x02\"\x14\n\x03\x41\x63k\x12\r\n\x05nonce\x18\x01 \x01(\r\"b\n\x03Log\x12\x13\n\x03msg\x18\x01 \x01(\tB\x06\x92?\x03p\xff\x01\x12\x1b\n\x05level\x18\x02 \x01(\x0e\x32\x0c.PB.LogLevel\x12\x16\n\x06origin\x18\x03 \x01(\tB\x06\x92?\x03p\x80\x01\x12\x11\n\tisVerbose\x18\x04 \x01(\x08\"\x86\x01\n\x0eSmartKnobState\x12\x18\n\x10\x63urrent_position\x18\x01 \x01(\x05\x12\x19\n\x11sub_position_unit\x18\x02 \x01(\x02\x12#\n\x06\x63onfig\x18\x03 \x01(\x0b\x32\x13.PB.SmartKnobConfig\x12\x1a\n\x0bpress_nonce\x18\x04 \x01(\rB\x05\x92?\x02\x38\x08\"\xdf\x02\n\x0fSmartKnobConfig\x12\x10\n\x08position\x18\x01 \x01(\x05\x12\x19\n\x11sub_position_unit\x18\x02 \x01(\x02\x12\x1d\n\x0eposition_nonce\x18\x03 \x01(\rB\x05\x92?\x02\x38\x08\x12\x14\n\x0cmin_position\x18\x04 \x01(\x05\x12\x14\n\x0cmax_position\x18\x05 \x01(\x05\x12\x1e\n\x16position_width_radians\x18\x06 \x01(\x02\x12\x1c\n\x14\x64\x65tent_strength_unit\x18\x07 \x01(\x02\x12\x1d\n\x15\x65ndstop_strength_unit\x18\x08 \x01(\x02\x12\x12\n\nsnap_point\x18\t \x01(\x02\x12\x11\n\x02id\x18\n \x01(\tB\x05\x92?\x02p@\x12\x1f\n\x10\x64\x65tent_positions\x18\x0b \x03(\x05\x42\x05\x92?\x02\x10\x05\x12\x17\n\x0fsnap_point_bias\x18\x0c \x01(\x02\x12\x16\n\x07led_hue\x18\r \x01(\x05\x42\x05\x92?\x02\x38\x10\"\x0e\n\x0cRequestState\"e\n\x17PersistentConfiguration\x12\x0f\n\x07version\x18\x01 \x01(\r\x12#\n\x05motor\x18\x02 \x01(\x0b\x32\x14.PB.MotorCalibration\x12\x14\n\x0cstrain_scale\x18\x03 \x01(\x02\"p\n\x10MotorCalibration\x12\x12\n\ncalibrated\x18\x01 \x01(\x08\x12\x1e\n\x16zero_electrical_offset\x18\x02 \x01(\x02\x12\x14\n\x0c\x64irection_cw\x18\x03 \x01(\x08\x12\x12\n\npole_pairs\x18\x04 \x01(\r\"8\n\x0bStrainState\x12\x14\n\x0cpress_weight\x18\x01 \x01(\x05\x12\x13\n\x0bpress_value\x18\x02 \x01(\x02\"/\n\x11StrainCalibration\x12\x1a\n\x12\x63\x61libration_weight\x18\x01 \x01(\x02*D\n\x08LogLevel\x12\x08\n\x04INFO\x10\x00\x12\x0b\n\x07WARNING\x10\x01\x12\t\n\x05\x45RROR\x10\x02\x12\t\n\x05\x44\x45\x42UG\x10\x03\x12\x0b\n\x07VERBOSE\x10\x04*P\n\x10SmartKnobCommand\x12\x11\n\rGET_KNOB_INFO\x10\x00\x12\x13\n\x0fMOTOR_CALIBRATE\x10\x01\x12\x14\n\x10STRAIN_CALIBRATE\x10\x02\x62\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0fsmartknob.proto\x12\x02PB\x1a\x0cnanopb.proto\x1a\x0esettings.proto\"\x9f\x03\n\rFromSmartKnob\x12\x1f\n\x10protocol_version\x18\x01 \x01(\rB\x05\x92?\x02\x38\x08\x12\x18\n\x04knob\x18\x03 \x01(\x0b\x32\x08.PB.KnobH\x00\x12\x16\n\x03\x61\x63k\x18\x04 \x01(\x0b\x32\x07.PB.AckH\x00\x12\x16\n\x03log\x18\x05 \x01(\x0b\x32\x07.PB.LogH\x00\x12-\n\x0fsmartknob_state\x18\x06 \x01(\x0b\x32\x12.PB.SmartKnobStateH\x00\x12\x30\n\x11motor_calib_state\x18\x07 \x01(\x0b\x32\x13.PB.MotorCalibStateH\x00\x12\x32\n\x12strain_calib_state\x18\x08 \x01(\x0b\x32\x14.PB.StrainCalibStateH\x00\x12\'\n\x0cmotor_timing\x18\t \x01(\x0b\x32\x0f.PB.MotorTimingH\x00\x12)\n\rmotor_thermal\x18\n \x01(\x0b\x32\x10.PB.MotorThermalH\x00\x12/\n\x10sensor_recording\x18\x0b \x01(\x0b\x32\x13.PB.SensorRecordingH\x00\x42\t\n\x07payload\"\x90\x03\n\x0bToSmartknob\x12\x1f\n\x10protocol_version\x18\x01 \x01(\rB\x05\x92?\x02\x38\x08\x12\r\n\x05nonce\x18\x02 \x01(\r\x12)\n\rrequest_state\x18\x03 \x01(\x0b\x32\x10.PB.RequestStateH\x00\x12/\n\x10smartknob_config\x18\x04 \x01(\x0b\x32\x13.PB.SmartKnobConfigH\x00\x12\x31\n\x11smartknob_command\x18\x05 \x01(\x0e\x32\x14.PB.SmartKnobCommandH\x00\x12\x33\n\x12strain_calibration\x18\x06 \x01(\x0b\x32\x15.PB.StrainCalibrationH\x00\x12&\n\x08settings\x18\x07 \x01(\x0b\x32\x12.SETTINGS.SettingsH\x00\x12/\n\x10\x64\x65tent_positions\x18\x08 \x01(\x0b\x32\x13.PB.DetentPositionsH\x00\x12)\n\rhaptic_effect\x18\t \x01(\x0b\x32\x10.PB.HapticEffectH\x00\x42\t\n\x07payload\"\x9b\x01\n\x04Knob\x12\x1a\n\x0bmac_address\x18\x01 \x01(\tB\x05\x92?\x02p2\x12\x19\n\nip_address\x18\x02 \x01(\tB\x05\x92?\x02p2\x12\x36\n\x11persistent_config\x18\x03 \x01(\x0b\x32\x1b.PB.PersistentConfiguration\x12$\n\x08settings\x18\x04 \x01(\x0b\x32\x12.SETTINGS.Settings\"\xa8\x01\n\x0fMotorCalibState\x12\x12\n\ncalibrated\x18\x01 \x01(\x08\x12\x0c\n\x04step\x18\x02 \x01(\r\x12\x10\n\x08progress\x18\x03 \x01(\x02\x12\x12\n\npole_pairs\x18\x04 \x01(\r\x12\x1e\n\x16zero_electrical_offset\x18\x05 \x01(\x02\x12\x14\n\x0c\x64irection_cw\x18\x06 \x01(\x08\x12\x17\n\x0fmax_angle_error\x18\x07 \x01(\x02\"6\n\x10StrainCalibState\x12\x0c\n\x04step\x18\x01 \x01(\r\x12\x14\n\x0cstrain_scale\x18\x02 \x01(\x02\"\x85\x01\n\x10MotorTimingStage\x12\x0e\n\x06min_us\x18\x01 \x01(\r\x12\x0e\n\x06max_us\x18\x02 \x01(\r\x12\x0f\n\x07mean_us\x18\x03 \x01(\x02\x12\r\n\x05\x63ount\x18\x04 \x01(\r\x12\x17\n\x0f\x62ucket_width_us\x18\x05 \x01(\r\x12\x18\n\thistogram\x18\x06 \x03(\rB\x05\x92?\x02\x10\x10\"\xf2\x01\n\x0bMotorTiming\x12\x0f\n\x07loop_hz\x18\x01 \x01(\r\x12\x14\n\x0cmissed_ticks\x18\x02 \x01(\r\x12$\n\x06period\x18\x03 \x01(\x0b\x32\x14.PB.MotorTimingStage\x12!\n\x03\x66oc\x18\x04 \x01(\x0b\x32\x14.PB.MotorTimingStage\x12&\n\x08\x63ommands\x18\x05 \x01(\x0b\x32\x14.PB.MotorTimingStage\x12$\n\x06\x64\x65tent\x18\x06 \x01(\x0b\x32\x14.PB.MotorTimingStage\x12%\n\x07publish\x18\x07 \x01(\x0b\x32\x14.PB.MotorTimingStage\"a\n\x0cMotorThermal\x12\x0e\n\x06\x62udget\x18\x01 \x01(\x02\x12\x14\n\x0ctorque_scale\x18\x02 \x01(\x02\x12\x13\n\x0b\x64ie_celsius\x18\x03 \x01(\x02\x12\x16\n\x0e\x64\x65rated_millis\x18\x04 \x01(\r\"\xeb\x01\n\x0cSensorSample\x12\x14\n\x0ctimestamp_us\x18\x01 \x01(\r\x12\x12\n\nstrain_raw\x18\x02 \x01(\x11\x12\x13\n\x0bstrain_load\x18\x03 \x01(\x02\x12\x17\n\x0fstrain_baseline\x18\x04 \x01(\x02\x12\x14\n\x0cproximity_mm\x18\x05 \x01(\r\x12\x18\n\x10proximity_status\x18\x06 \x01(\r\x12\x0b\n\x03lux\x18\x07 \x01(\x02\x12\x1b\n\x13temperature_celsius\x18\x08 \x01(\x02\x12\x13\n\x0bmotor_angle\x18\t \x01(\x02\x12\x14\n\x0cmotor_torque\x18\n \x01(\x02\"q\n\x0fSensorRecording\x12\x0e\n\x06offset\x18\x01 \x01(\r\x12\r\n\x05total\x18\x02 \x01(\r\x12\x15\n\rtrigger_index\x18\x03 \x01(\r\x12(\n\x07samples\x18\x04 \x03(\x0b\x32\x10.PB.SensorSampleB\x05\x92?\x02\x10\n\"\x14\n\x03\x41\x63k\x12\r\n\x05nonce\x18\x01 \x01(\r\"b\n\x03Log\x12\x13\n\x03msg\x18\x01 \x01(\tB\x06\x92?\x03p\xff\x01\x12\x1b\n\x05level\x18\x02 \x01(\x0e\x32\x0c.PB.LogLevel\x12\x16\n\x06origin\x18\x03 \x01(\tB\x06\x92?\x03p\x80\x01\x12\x11\n\tisVerbose\x18\x04 \x01(\x08\"\x86\x01\n\x0eSmartKnobState\x12\x18\n\x10\x63urrent_position\x18\x01 \x01(\x05\x12\x19\n\x11sub_position_unit\x18\x02 \x01(\x02\x12#\n\x06\x63onfig\x18\x03 \x01(\x0b\x32\x13.PB.SmartKnobConfig\x12\x1a\n\x0bpress_nonce\x18\x04 \x01(\rB\x05\x92?\x02\x38\x08\"\xdf\x02\n\x0fSmartKnobConfig\x12\x10\n\x08position\x18\x01 \x01(\x05\x12\x19\n\x11sub_position_unit\x18\x02 \x01(\x02\x12\x1d\n\x0eposition_nonce\x18\x03 \x01(\rB\x05\x92?\x02\x38\x08\x12\x14\n\x0cmin_position\x18\x04 \x01(\x05\x12\x14\n\x0cmax_position\x18\x05 \x01(\x05\x12\x1e\n\x16position_width_radians\x18\x06 \x01(\x02\x12\x1c\n\x14\x64\x65tent_strength_unit\x18\x07 \x01(\x02\x12\x1d\n\x15\x65ndstop_strength_unit\x18\x08 \x01(\x02\x12\x12\n\nsnap_point\x18\t \x01(\x02\x12\x11\n\x02id\x18\n \x01(\tB\x05\x92?\x02p@\x12\x1f\n\x10\x64\x65tent_positions\x18\x0b \x03(\x05\x42\x05\x92?\x02\x10\x05\x12\x17\n\x0fsnap_point_bias\x18\x0c \x01(\x02\x12\x16\n\x07led_hue\x18\r \x01(\x05\x42\x05\x92?\x02\x38\x10\"\x0e\n\x0cRequestState\"\x8e\x01\n\x17PersistentConfiguration\x12\x0f\n\x07version\x18\x01 \x01(\r\x12#\n\x05motor\x18\x02 \x01(\x0b\x32\x14.PB.MotorCalibration\x12\x14\n\x0cstrain_scale\x18\x03 \x01(\x02\x12\'\n\rgain_schedule\x18\x04 \x01(\x0b\x32\x10.PB.GainSchedule\"\x91\x01\n\x10MotorCalibration\x12\x12\n\ncalibrated\x18\x01 \x01(\x08\x12\x1e\n\x16zero_electrical_offset\x18\x02 \x01(\x02\x12\x14\n\x0c\x64irection_cw\x18\x03 \x01(\x08\x12\x12\n\npole_pairs\x18\x04 \x01(\r\x12\x1f\n\x10\x61ngle_correction\x18\x05 \x03(\x02\x42\x05\x92?\x02\x10 \"=\n\x0cGainSchedule\x12-\n\x07\x65ntries\x18\x01 \x03(\x0b\x32\x15.PB.GainScheduleEntryB\x05\x92?\x02\x10\x08\"_\n\x11GainScheduleEntry\x12\x1e\n\x16position_width_radians\x18\x01 \x01(\x02\x12\t\n\x01p\x18\x02 \x01(\x02\x12\t\n\x01\x64\x18\x03 \x01(\x02\x12\x14\n\x0ctorque_limit\x18\x04 \x01(\x02\"8\n\x0bStrainState\x12\x14\n\x0cpress_weight\x18\x01 \x01(\x05\x12\x13\n\x0bpress_value\x18\x02 \x01(\x02\"/\n\x11StrainCalibration\x12\x1a\n\x12\x63\x61libration_weight\x18\x01 \x01(\x02\"\x8d\x01\n\x0f\x44\x65tentPositions\x12\x18\n\tconfig_id\x18\x01 \x01(\tB\x05\x92?\x02p@\x12\x0e\n\x06offset\x18\x02 \x01(\r\x12\r\n\x05total\x18\x03 \x01(\r\x12\x18\n\tpositions\x18\x04 \x03(\x05\x42\x05\x92?\x02\x10 \x12\x13\n\x0brange_start\x18\x05 \x01(\x05\x12\x12\n\nrange_step\x18\x06 \x01(\x05\"`\n\x0cHapticEffect\x12\x10\n\x08waveform\x18\x01 \x01(\r\x12\x10\n\x08strength\x18\x02 \x01(\x02\x12\x14\n\x0csample_ticks\x18\x03 \x01(\r\x12\x16\n\x07samples\x18\x04 \x01(\x0c\x42\x05\x92?\x02\x08@*D\n\x08LogLevel\x12\x08\n\x04INFO\x10\x00\x12\x0b\n\x07WARNING\x10\x01\x12\t\n\x05\x45RROR\x10\x02\x12\t\n\x05\x44\x45\x42UG\x10\x03\x12\x0b\n\x07VERBOSE\x10\x04*\xcc\x01\n\x10SmartKnobCommand\x12\x11\n\rGET_KNOB_INFO\x10\x00\x12\x13\n\x0fMOTOR_CALIBRATE\x10\x01\x12\x14\n\x10STRAIN_CALIBRATE\x10\x02\x12\x14\n\x10GET_MOTOR_TIMING\x10\x03\x12\x12\n\x0eMOTOR_AUTOTUNE\x10\x04\x12\x15\n\x11GET_MOTOR_THERMAL\x10\x05\x12\x10\n\x0cRECORDER_ARM\x10\x06\x12\x14\n\x10RECORDER_TRIGGER\x10\x07\x12\x11\n\rRECORDER_DUMP\x10\x08\x62\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
@@ -41,6 +41,10 @@ if not _descriptor._USE_C_DESCRIPTORS:
   _globals['_KNOB'].fields_by_name['mac_address']._serialized_options = b'\222?\002p2'
   _globals['_KNOB'].fields_by_name['ip_address']._loaded_options = None
   _globals['_KNOB'].fields_by_name['ip_address']._serialized_options = b'\222?\002p2'
+  _globals['_MOTORTIMINGSTAGE'].fields_by_name['histogram']._loaded_options = None
+  _globals['_MOTORTIMINGSTAGE'].fields_by_name['histogram']._serialized_options = b'\222?\002\020\020'
+  _globals['_SENSORRECORDING'].fields_by_name['samples']._loaded_options = None
+  _globals['_SENSORRECORDING'].fields_by_name['samples']._serialized_options = b'\222?\002\020\n'
   _globals['_LOG'].fields_by_name['msg']._loaded_options = None
   _globals['_LOG'].fields_by_name['msg']._serialized_options = b'\222?\003p\377\001'
   _globals['_LOG'].fields_by_name['origin']._loaded_options = None
@@ -55,36 +59,64 @@ if not _descriptor._USE_C_DESCRIPTORS:
   _globals['_SMARTKNOBCONFIG'].fields_by_name['detent_positions']._serialized_options = b'\222?\002\020\005'
   _globals['_SMARTKNOBCONFIG'].fields_by_name['led_hue']._loaded_options = None
   _globals['_SMARTKNOBCONFIG'].fields_by_name['led_hue']._serialized_options = b'\222?\0028\020'
-  _globals['_LOGLEVEL']._serialized_start=1855
-  _globals['_LOGLEVEL']._serialized_end=1923
-  _globals['_SMARTKNOBCOMMAND']._serialized_start=1925
-  _globals['_SMARTKNOBCOMMAND']._serialized_end=2005
+  _globals['_MOTORCALIBRATION'].fields_by_name['angle_correction']._loaded_options = None
+  _globals['_MOTORCALIBRATION'].fields_by_name['angle_correction']._serialized_options = b'\222?\002\020 '
+  _globals['_GAINSCHEDULE'].fields_by_name['entries']._loaded_options = None
+  _globals['_GAINSCHEDULE'].fields_by_name['entries']._serialized_options = b'\222?\002\020\010'
+  _globals['_DETENTPOSITIONS'].fields_by_name['config_id']._loaded_options = None
+  _globals['_DETENTPOSITIONS'].fields_by_name['config_id']._serialized_options = b'\222?\002p@'
+  _globals['_DETENTPOSITIONS'].fields_by_name['positions']._loaded_options = None
+  _globals['_DETENTPOSITIONS'].fields_by_name['positions']._serialized_options = b'\222?\002\020 '
+  _globals['_HAPTICEFFECT'].fields_by_name['samples']._loaded_options = None
+  _globals['_HAPTICEFFECT'].fields_by_name['samples']._serialized_options = b'\222?\002\010@'
+  _globals['_LOGLEVEL']._serialized_start=3523
+  _globals['_LOGLEVEL']._serialized_end=3591
+  _globals['_SMARTKNOBCOMMAND']._serialized_start=3594
+  _globals['_SMARTKNOBCOMMAND']._serialized_end=3798
   _globals['_FROMSMARTKNOB']._serialized_start=54
-  _globals['_FROMSMARTKNOB']._serialized_end=336
-  _globals['_TOSMARTKNOB']._serialized_start=339
-  _globals['_TOSMARTKNOB']._serialized_end=647
-  _globals['_KNOB']._serialized_start=650
-  _globals['_KNOB']._serialized_end=805
-  _globals['_MOTORCALIBSTATE']._serialized_start=807
-  _globals['_MOTORCALIBSTATE']._serialized_end=844
-  _globals['_STRAINCALIBSTATE']._serialized_start=846
-  _globals['_STRAINCALIBSTATE']._serialized_end=900
-  _globals['_ACK']._serialized_start=902
-  _globals['_ACK']._serialized_end=922
-  _globals['_LOG']._serialized_start=924
-  _globals['_LOG']._serialized_end=1022
-  _globals['_SMARTKNOBSTATE']._serialized_start=1025
-  _globals['_SMARTKNOBSTATE']._serialized_end=1159
-  _globals['_SMARTKNOBCONFIG']._serialized_start=1162
-  _globals['_SMARTKNOBCONFIG']._serialized_end=1513
-  _globals['_REQUESTSTATE']._serialized_start=1515
-  _globals['_REQUESTSTATE']._serialized_end=1529
-  _globals['_PERSISTENTCONFIGURATION']._serialized_start=1531
-  _globals['_PERSISTENTCONFIGURATION']._serialized_end=1632
-  _globals['_MOTORCALIBRATION']._serialized_start=1634
-  _globals['_MOTORCALIBRATION']._serialized_end=1746
-  _globals['_STRAINSTATE']._serialized_start=1748
-  _globals['_STRAINSTATE']._serialized_end=1804
-  _globals['_STRAINCALIBRATION']._serialized_start=1806
-  _globals['_STRAINCALIBRATION']._serialized_end=1853
+  _globals['_FROMSMARTKNOB']._serialized_end=469
+  _globals['_TOSMARTKNOB']._serialized_start=472
+  _globals['_TOSMARTKNOB']._serialized_end=872
+  _globals['_KNOB']._serialized_start=875
+  _globals['_KNOB']._serialized_end=1030
+  _globals['_MOTORCALIBSTATE']._serialized_start=1033
+  _globals['_MOTORCALIBSTATE']._serialized_end=1201
+  _globals['_STRAINCALIBSTATE']._serialized_start=1203
+  _globals['_STRAINCALIBSTATE']._serialized_end=1257
+  _globals['_MOTORTIMINGSTAGE']._serialized_start=1260
+  _globals['_MOTORTIMINGSTAGE']._serialized_end=1393
+  _globals['_MOTORTIMING']._serialized_start=1396
+  _globals['_MOTORTIMING']._serialized_end=1638
+  _globals['_MOTORTHERMAL']._serialized_start=1640
+  _globals['_MOTORTHERMAL']._serialized_end=1737
+  _globals['_SENSORSAMPLE']._serialized_start=1740
+  _globals['_SENSORSAMPLE']._serialized_end=1975
+  _globals['_SENSORRECORDING']._serialized_start=1977
+  _globals['_SENSORRECORDING']._serialized_end=2090
+  _globals['_ACK']._serialized_start=2092
+  _globals['_ACK']._serialized_end=2112
+  _globals['_LOG']._serialized_start=2114
+  _globals['_LOG']._serialized_end=2212
+  _globals['_SMARTKNOBSTATE']._serialized_start=2215
+  _globals['_SMARTKNOBSTATE']._serialized_end=2349
+  _globals['_SMARTKNOBCONFIG']._serialized_start=2352
+  _globals['_SMARTKNOBCONFIG']._serialized_end=2703
+  _globals['_REQUESTSTATE']._serialized_start=2705
+  _globals['_REQUESTSTATE']._serialized_end=2719
+  _globals['_PERSISTENTCONFIGURATION']._serialized_start=2722
+  _globals['_PERSISTENTCONFIGURATION']._serialized_end=2864
+  _globals['_MOTORCALIBRATION']._serialized_start=2867
+  _globals['_MOTORCALIBRATION']._serialized_end=3012
+  _globals['_GAINSCHEDULE']._serialized_start=3014
+  _globals['_GAINSCHEDULE']._serialized_end=3075
+  _globals['_GAINSCHEDULEENTRY']._serialized_start=3077
+  _globals['_GAINSCHEDULEENTRY']._serialized_end=3172
+  _globals['_STRAINSTATE']._serialized_start=3174
+  _globals['_STRAINSTATE']._serialized_end=3230
+  _globals['_STRAINCALIBRATION']._serialized_start=3232
+  _globals['_STRAINCALIBRATION']._serialized_end=3279
+  _globals['_DETENTPOSITIONS']._serialized_start=3282
+  _globals['_DETENTPOSITIONS']._serialized_end=3423
+  _globals['_HAPTICEFFECT']._serialized_start=3425
+  _globals['_HAPTICEFFECT']._serialized_end=3521
 # @@protoc_insertion_point(module_scope)